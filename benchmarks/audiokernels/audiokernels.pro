@@ -0,0 +1,23 @@
+#-------------------------------------------------
+#
+# Times the float audio kernels against the per-sample int16 code they replaced.
+# Build in release mode on its own, it isn't part of Olive itself.
+#
+#-------------------------------------------------
+
+QT       -= gui
+
+CONFIG += console c++11 release
+CONFIG -= app_bundle
+
+TARGET = audiokernels
+TEMPLATE = app
+
+INCLUDEPATH += ../..
+
+SOURCES += \
+    main.cpp \
+    ../../playback/audiokernels.cpp
+
+HEADERS += \
+    ../../playback/audiokernels.h
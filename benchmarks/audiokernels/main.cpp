@@ -0,0 +1,186 @@
+#include "playback/audiokernels.h"
+
+#include <QElapsedTimer>
+#include <QVector>
+#include <QtMath>
+
+#include <cstdio>
+#include <cstdint>
+
+#define BENCH_FREQUENCY 48000
+#define BENCH_CHANNELS 2
+#define BENCH_SECONDS 10 // of audio per run
+#define BENCH_RUNS 9 // the fastest run is reported
+
+#define BENCH_VOLUME 0.8
+#define BENCH_VOLUME_END 0.6
+#define BENCH_FREQ 1000.0
+#define BENCH_AMOUNT 0.25
+
+// the sequence's mix buffer is interleaved 16-bit, the same as effects receive it
+struct BenchBuffer {
+	QVector<qint16> source;
+	QVector<qint16> samples;
+	int nb_frames;
+};
+
+/* per-sample code as it was before the float kernels, the keyframe lookups it also made
+   for every sample are left out so only the sample processing itself is compared */
+
+qint16 old_mix_sample(qint16 a, qint16 b) {
+	qint32 mixed_sample = static_cast<qint32>(a) + static_cast<qint32>(b);
+	mixed_sample = qMax(qMin(mixed_sample, static_cast<qint32>(INT16_MAX)), static_cast<qint32>(INT16_MIN));
+	return static_cast<qint16>(mixed_sample);
+}
+
+void old_volume(BenchBuffer& b) {
+	quint8* samples = reinterpret_cast<quint8*>(b.samples.data());
+	int nb_bytes = b.samples.size()*2;
+	double interval = (BENCH_VOLUME_END-BENCH_VOLUME)/nb_bytes;
+	for (int i=0;i<nb_bytes;i+=2) {
+		double vol_val = BENCH_VOLUME+(interval*i);
+		qint32 samp = (qint16) (((samples[i+1] & 0xFF) << 8) | (samples[i] & 0xFF));
+		double val = qPow(vol_val, 3);
+		samp *= val;
+		if (samp > INT16_MAX) {
+			samp = INT16_MAX;
+		} else if (samp < INT16_MIN) {
+			samp = INT16_MIN;
+		}
+		samples[i+1] = (quint8) (samp >> 8);
+		samples[i] = (quint8) samp;
+	}
+}
+
+void old_tone(BenchBuffer& b) {
+	quint8* samples = reinterpret_cast<quint8*>(b.samples.data());
+	int nb_bytes = b.samples.size()*2;
+	int frame_size = BENCH_CHANNELS << 1;
+	int sinX = 0;
+	for (int i=0;i<nb_bytes;i+=frame_size) {
+		qint16 tone_sample = qSin((2*M_PI*sinX*BENCH_FREQ)/BENCH_FREQUENCY)*BENCH_AMOUNT*INT16_MAX;
+		for (int j=0;j<frame_size;j+=2) {
+			qint16 source_sample = (qint16) (((samples[i+j+1] & 0xFF) << 8) | (samples[i+j] & 0xFF));
+			qint16 channel_sample = old_mix_sample(tone_sample, source_sample);
+			samples[i+j+1] = (quint8) (channel_sample >> 8);
+			samples[i+j] = (quint8) channel_sample;
+		}
+		sinX++;
+	}
+}
+
+/* the same work through the block functions VolumeEffect and ToneEffect call, only their keyframe lookups are
+   swapped for the constants above */
+
+void new_volume(BenchBuffer& b) {
+	qint16* data = b.samples.data();
+	double interval = (BENCH_VOLUME_END-BENCH_VOLUME)/b.nb_frames;
+	float gain_start = qPow(BENCH_VOLUME, 3);
+	int block_frames = get_block_frames(BENCH_CHANNELS);
+	for (int i=0;i<b.nb_frames;i+=block_frames) {
+		int count = qMin(block_frames, b.nb_frames-i);
+		float gain_end = qPow(BENCH_VOLUME+(interval*(i+count)), 3);
+		gain_samples_block(data+i*BENCH_CHANNELS, count, BENCH_CHANNELS, gain_start, gain_end);
+		gain_start = gain_end;
+	}
+}
+
+void new_tone(BenchBuffer& b) {
+	qint16* data = b.samples.data();
+	float tone[AUDIO_KERNEL_BLOCK];
+	double increment = BENCH_FREQ/BENCH_FREQUENCY;
+	double phase = 0;
+	float amount = BENCH_AMOUNT*INT16_MAX;
+	int block_frames = get_block_frames(BENCH_CHANNELS);
+	for (int i=0;i<b.nb_frames;i+=block_frames) {
+		int count = qMin(block_frames, b.nb_frames-i);
+		phase = sine_block(tone, count, phase, increment);
+		apply_gain_ramp(tone, count, 1, amount, amount);
+		mix_mono_samples_block(data+i*BENCH_CHANNELS, count, BENCH_CHANNELS, tone, false);
+	}
+}
+
+/* each kernel on its own over the whole buffer */
+
+QVector<float> float_samples;
+
+void kernel_conversion(BenchBuffer& b) {
+	samples_to_float(b.samples.constData(), float_samples.data(), b.samples.size());
+	float_to_samples(float_samples.constData(), b.samples.data(), b.samples.size());
+}
+
+void kernel_constant_gain(BenchBuffer& b) {
+	apply_gain_ramp(float_samples.data(), b.nb_frames, BENCH_CHANNELS, 0.5f, 0.5f);
+}
+
+void kernel_gain_ramp(BenchBuffer& b) {
+	apply_gain_ramp(float_samples.data(), b.nb_frames, BENCH_CHANNELS, 0.5f, 0.6f);
+}
+
+void kernel_sine(BenchBuffer& b) {
+	double phase = 0;
+	for (int i=0;i<b.nb_frames;i+=AUDIO_KERNEL_BLOCK) {
+		phase = sine_block(float_samples.data()+i, qMin(AUDIO_KERNEL_BLOCK, b.nb_frames-i), phase, BENCH_FREQ/BENCH_FREQUENCY);
+	}
+}
+
+void kernel_mix_mono(BenchBuffer& b) {
+	// the first nb_frames floats stand in for the mono tone
+	static QVector<float> mono(float_samples.mid(0, b.nb_frames));
+	mix_mono_block(float_samples.data(), b.nb_frames, BENCH_CHANNELS, mono.constData(), false);
+}
+
+// nanoseconds per sample of the fastest of BENCH_RUNS runs, each starting from the same source audio
+double time_run(BenchBuffer& b, void (*run)(BenchBuffer&)) {
+	qint64 best = -1;
+	for (int i=0;i<BENCH_RUNS;i++) {
+		b.samples = b.source;
+		b.samples.detach();
+		QElapsedTimer timer;
+		timer.start();
+		run(b);
+		qint64 elapsed = timer.nsecsElapsed();
+		if (best < 0 || elapsed < best) best = elapsed;
+	}
+	return (double) best / b.source.size();
+}
+
+void compare(BenchBuffer& b, const char* name, void (*old_run)(BenchBuffer&), void (*new_run)(BenchBuffer&)) {
+	double old_ns = time_run(b, old_run);
+	double new_ns = time_run(b, new_run);
+	printf("%-28s %8.3f ns/sample -> %8.3f ns/sample  (%.1fx)\n", name, old_ns, new_ns, old_ns/new_ns);
+}
+
+void measure(BenchBuffer& b, const char* name, void (*run)(BenchBuffer&)) {
+	printf("%-28s %8.3f ns/sample\n", name, time_run(b, run));
+}
+
+int main() {
+	BenchBuffer b;
+	b.nb_frames = BENCH_FREQUENCY*BENCH_SECONDS;
+	b.source.resize(b.nb_frames*BENCH_CHANNELS);
+
+	// full scale noise from a fixed seed so every run sees the same audio
+	quint32 state = 0x9e3779b9;
+	for (int i=0;i<b.source.size();i++) {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		b.source[i] = static_cast<qint16>(state);
+	}
+	float_samples.resize(b.source.size());
+	samples_to_float(b.source.constData(), float_samples.data(), b.source.size());
+
+	printf("%d s of %d Hz audio, %d channels, fastest of %d runs\n\n", BENCH_SECONDS, BENCH_FREQUENCY, BENCH_CHANNELS, BENCH_RUNS);
+	printf("per-sample int16 -> float blocks\n");
+	compare(b, "volume (ramped)", old_volume, new_volume);
+	compare(b, "tone (mixed)", old_tone, new_tone);
+	printf("\nkernels\n");
+	measure(b, "samples_to_float + back", kernel_conversion);
+	measure(b, "apply_gain_ramp (constant)", kernel_constant_gain);
+	measure(b, "apply_gain_ramp (ramped)", kernel_gain_ramp);
+	measure(b, "sine_block", kernel_sine);
+	measure(b, "mix_mono_block", kernel_mix_mono);
+
+	return 0;
+}
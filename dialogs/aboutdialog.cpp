@@ -1,14 +1,14 @@
-#include "aboutdialog.h"
-#include "ui_aboutdialog.h"
-
-AboutDialog::AboutDialog(QWidget *parent) :
-	QDialog(parent),
-	ui(new Ui::AboutDialog)
-{
-	ui->setupUi(this);
-}
-
-AboutDialog::~AboutDialog()
-{
-	delete ui;
-}
+#include "aboutdialog.h"
+#include "ui_aboutdialog.h"
+
+AboutDialog::AboutDialog(QWidget *parent) :
+	QDialog(parent),
+	ui(new Ui::AboutDialog)
+{
+	ui->setupUi(this);
+}
+
+AboutDialog::~AboutDialog()
+{
+	delete ui;
+}
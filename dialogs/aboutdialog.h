@@ -1,22 +1,22 @@
-#ifndef ABOUTDIALOG_H
-#define ABOUTDIALOG_H
-
-#include <QDialog>
-
-namespace Ui {
-class AboutDialog;
-}
-
-class AboutDialog : public QDialog
-{
-	Q_OBJECT
-
-public:
-	explicit AboutDialog(QWidget *parent = 0);
-	~AboutDialog();
-
-private:
-	Ui::AboutDialog *ui;
-};
-
-#endif // ABOUTDIALOG_H
+#ifndef ABOUTDIALOG_H
+#define ABOUTDIALOG_H
+
+#include <QDialog>
+
+namespace Ui {
+class AboutDialog;
+}
+
+class AboutDialog : public QDialog
+{
+	Q_OBJECT
+
+public:
+	explicit AboutDialog(QWidget *parent = 0);
+	~AboutDialog();
+
+private:
+	Ui::AboutDialog *ui;
+};
+
+#endif // ABOUTDIALOG_H
@@ -2,6 +2,10 @@
 #include "ui_preferencesdialog.h"
 
 #include "io/config.h"
+#include "playback/audio.h"
+#include "panels/panels.h"
+#include "panels/timeline.h"
+#include "project/sequence.h"
 
 #include <QMenuBar>
 #include <QAction>
@@ -24,6 +28,13 @@ PreferencesDialog::PreferencesDialog(QWidget *parent) :
     ui->setupUi(this);
 
     ui->imgSeqFormatEdit->setText(config.img_seq_formats);
+    ui->ramPreviewMemorySpinbox->setValue(config.ram_preview_memory);
+    ui->softwareRenderingCheckbox->setChecked(config.software_rendering);
+
+    ui->audioBufferSpinbox->setValue(config.audio_buffer_ms);
+    ui->audioNotifySpinbox->setValue(config.audio_notify_interval);
+    ui->lowLatencyCheckbox->setChecked(config.low_latency_audio);
+    ui->audioLatencyOffsetSpinbox->setValue(config.audio_latency_offset);
 }
 
 PreferencesDialog::~PreferencesDialog() {
@@ -76,4 +87,21 @@ void PreferencesDialog::setup_kbd_shortcuts(QMenuBar* menubar) {
 
 void PreferencesDialog::on_buttonBox_accepted() {
     config.img_seq_formats = ui->imgSeqFormatEdit->text();
+    config.ram_preview_memory = ui->ramPreviewMemorySpinbox->value();
+    config.software_rendering = ui->softwareRenderingCheckbox->isChecked();
+
+    bool audio_changed = (config.audio_buffer_ms != ui->audioBufferSpinbox->value()
+                          || config.audio_notify_interval != ui->audioNotifySpinbox->value()
+                          || config.low_latency_audio != ui->lowLatencyCheckbox->isChecked());
+    config.audio_buffer_ms = ui->audioBufferSpinbox->value();
+    config.audio_notify_interval = ui->audioNotifySpinbox->value();
+    config.low_latency_audio = ui->lowLatencyCheckbox->isChecked();
+    config.audio_latency_offset = ui->audioLatencyOffsetSpinbox->value();
+
+    if (audio_changed && sequence != NULL) {
+        // restart the output device with the new buffer settings
+        panel_timeline->pause();
+        init_audio();
+        panel_timeline->reset_all_audio();
+    }
 }
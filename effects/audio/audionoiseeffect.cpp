@@ -1,45 +1,65 @@
-#include "audionoiseeffect.h"
-
-#include <QDateTime>
-
-AudioNoiseEffect::AudioNoiseEffect(Clip* c) : Effect(c, EFFECT_TYPE_AUDIO, AUDIO_NOISE_EFFECT) {
-	amount_val = add_row("Amount:")->add_field(EFFECT_FIELD_DOUBLE);
-	amount_val->set_double_minimum_value(0);
-	amount_val->set_double_maximum_value(100);
-	amount_val->set_double_default_value(20);
-
-	mix_val = add_row("Mix:")->add_field(EFFECT_FIELD_BOOL);
-	mix_val->set_bool_value(true);
-
-	srand(QDateTime::currentMSecsSinceEpoch());
-
-	connect(amount_val, SIGNAL(changed()), this, SLOT(field_changed()));
-	connect(mix_val, SIGNAL(changed()), this, SLOT(field_changed()));
-}
-
-void AudioNoiseEffect::process_audio(double timecode_start, double timecode_end, quint8 *samples, int nb_bytes, int) {
-	double interval = (timecode_end - timecode_start)/nb_bytes;
-	for (int i=0;i<nb_bytes;i+=4) {
-		double timecode = timecode_start+(interval*i);
-
-		qint16 left_noise_sample = rand();
-		qint16 right_noise_sample = rand();
-
-		// set noise volume
-		left_noise_sample *= amount_val->get_double_value(timecode)*0.01;
-		right_noise_sample *= amount_val->get_double_value(timecode)*0.01;
-
-		// mix with source audio
-		if (mix_val->get_bool_value(timecode)) {
-			qint16 left_sample = (qint16) (((samples[i+1] & 0xFF) << 8) | (samples[i] & 0xFF));
-			qint16 right_sample = (qint16) (((samples[i+3] & 0xFF) << 8) | (samples[i+2] & 0xFF));
-			left_noise_sample = mixAudioSample(left_noise_sample, left_sample);
-			right_noise_sample = mixAudioSample(right_noise_sample, right_sample);
-		}
-
-		samples[i+3] = (quint8) (right_noise_sample >> 8);
-		samples[i+2] = (quint8) right_noise_sample;
-		samples[i+1] = (quint8) (left_noise_sample >> 8);
-		samples[i] = (quint8) left_noise_sample;
-	}
-}
+#include "audionoiseeffect.h"
+
+#include "playback/audio.h"
+
+#include <QtMath>
+
+AudioNoiseEffect::AudioNoiseEffect(Clip* c) : Effect(c, EFFECT_TYPE_AUDIO, AUDIO_NOISE_EFFECT) {
+	amount_val = add_row("Amount:")->add_field(EFFECT_FIELD_DOUBLE);
+	amount_val->set_double_minimum_value(0);
+	amount_val->set_double_maximum_value(100);
+	amount_val->set_double_default_value(20);
+
+	mix_val = add_row("Mix:")->add_field(EFFECT_FIELD_BOOL);
+	mix_val->set_bool_value(true);
+
+	// saved with the project, so the noise comes out the same on every playback and export
+	seed_val = add_row("Seed:")->add_field(EFFECT_FIELD_DOUBLE);
+	seed_val->set_double_minimum_value(0);
+	seed_val->set_double_default_value(qrand() % 10000);
+
+	connect(amount_val, SIGNAL(changed()), this, SLOT(field_changed()));
+	connect(mix_val, SIGNAL(changed()), this, SLOT(field_changed()));
+	connect(seed_val, SIGNAL(changed()), this, SLOT(field_changed()));
+}
+
+void AudioNoiseEffect::process_audio(double timecode_start, double timecode_end, quint8 *samples, int nb_bytes, int channel_count) {
+	int nb_frames = nb_bytes / (channel_count << 1);
+	if (nb_frames == 0) return;
+	double interval = (timecode_end - timecode_start)/nb_frames;
+	qint16* data = reinterpret_cast<qint16*>(samples);
+	float block[AUDIO_KERNEL_BUFFER];
+	float noise[AUDIO_KERNEL_BUFFER];
+
+	// every sample's noise comes from its position in the clip, so seeking or caching out of order can't change it
+	quint32 seed = qRound(seed_val->get_double_value(timecode_start));
+	quint64 first_sample = qRound64(timecode_start / interval) * channel_count;
+
+	float amount_start = amount_val->get_double_value(timecode_start)*0.01;
+	int block_frames = get_block_frames(channel_count);
+	for (int i=0;i<nb_frames;i+=block_frames) {
+		int count = qMin(block_frames, nb_frames-i);
+		int block_size = count*channel_count;
+		float amount_end = amount_val->get_double_value(timecode_start+(interval*(i+count)))*0.01;
+		bool mix = mix_val->get_bool_value(timecode_start+(interval*i));
+
+		// independent full scale noise per channel
+		quint64 block_sample = first_sample + static_cast<quint64>(i)*channel_count;
+		for (int j=0;j<block_size;j++) {
+			noise[j] = static_cast<qint16>(random_hash(seed, block_sample + j) >> 16);
+		}
+		apply_gain_ramp(noise, count, channel_count, amount_start, amount_end);
+
+		if (mix) {
+			samples_to_float(data+i*channel_count, block, block_size);
+			for (int j=0;j<block_size;j++) {
+				block[j] += noise[j];
+			}
+			float_to_samples(block, data+i*channel_count, block_size);
+		} else {
+			float_to_samples(noise, data+i*channel_count, block_size);
+		}
+
+		amount_start = amount_end;
+	}
+}
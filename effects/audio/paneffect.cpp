@@ -1,44 +1,47 @@
-#include "paneffect.h"
-
-#include <QGridLayout>
-#include <QLabel>
-#include <QtMath>
-#include <cmath>
-
-#include "ui/labelslider.h"
-#include "ui/collapsiblewidget.h"
-
-PanEffect::PanEffect(Clip* c) : Effect(c, EFFECT_TYPE_AUDIO, AUDIO_PAN_EFFECT) {
-	EffectRow* pan_row = add_row("Pan:");
-	pan_val = pan_row->add_field(EFFECT_FIELD_DOUBLE);
-	pan_val->set_double_minimum_value(-100);
-	pan_val->set_double_maximum_value(100);
-
-	// set defaults
-	pan_val->set_double_default_value(0);
-
-	connect(pan_val, SIGNAL(changed()), this, SLOT(field_changed()));
-}
-
-void PanEffect::process_audio(double timecode_start, double timecode_end, quint8* samples, int nb_bytes, int) {
-	double interval = (timecode_end - timecode_start)/nb_bytes;
-	for (int i=0;i<nb_bytes;i+=4) {
-		double pval = pan_val->get_double_value(timecode_start+(interval*i));
-		qint16 left_sample = (qint16) (((samples[i+1] & 0xFF) << 8) | (samples[i] & 0xFF));
-		qint16 right_sample = (qint16) (((samples[i+3] & 0xFF) << 8) | (samples[i+2] & 0xFF));
-
-		double val = qPow(pval*0.01, 3);
-		if (val < 0) {
-			// affect right channel
-			right_sample *= (1-std::abs(val));
-		} else {
-			// affect left channel
-			left_sample *= (1-val);
-		}
-
-		samples[i+3] = (quint8) (right_sample >> 8);
-		samples[i+2] = (quint8) right_sample;
-		samples[i+1] = (quint8) (left_sample >> 8);
-		samples[i] = (quint8) left_sample;
-	}
-}
+#include "paneffect.h"
+
+#include <QGridLayout>
+#include <QLabel>
+#include <QtMath>
+#include <cmath>
+
+#include "ui/labelslider.h"
+#include "ui/collapsiblewidget.h"
+#include "project/clip.h"
+#include "project/sequence.h"
+#include "playback/audio.h"
+
+PanEffect::PanEffect(Clip* c) : Effect(c, EFFECT_TYPE_AUDIO, AUDIO_PAN_EFFECT) {
+	EffectRow* pan_row = add_row("Pan:");
+	pan_val = pan_row->add_field(EFFECT_FIELD_DOUBLE);
+	pan_val->set_double_minimum_value(-100);
+	pan_val->set_double_maximum_value(100);
+
+	// set defaults
+	pan_val->set_double_default_value(0);
+
+	connect(pan_val, SIGNAL(changed()), this, SLOT(field_changed()));
+}
+
+void PanEffect::process_audio(double timecode_start, double timecode_end, quint8* samples, int nb_bytes, int channel_count) {
+	quint64 layout = parent_clip->sequence->audio_layout;
+	int nb_frames = nb_bytes / (channel_count << 1);
+	if (nb_frames == 0) return;
+	double interval = (timecode_end - timecode_start)/nb_frames;
+	qint16* data = reinterpret_cast<qint16*>(samples);
+
+	float gains[AUDIO_LAYOUT_MAX_CHANNELS];
+	double last_val = -2; // outside the pan range, forces the first gain calculation
+	for (int i=0;i<nb_frames;i+=AUDIO_KERNEL_BLOCK) {
+		int count = qMin(AUDIO_KERNEL_BLOCK, nb_frames-i);
+		double val = qPow(pan_val->get_double_value(timecode_start+(interval*i))*0.01, 3);
+
+		// only rebuild the gain vector when the (possibly keyframed) pan value actually moves
+		if (val != last_val) {
+			get_pan_gains(layout, val, gains);
+			last_val = val;
+		}
+
+		apply_channel_gains(data+i*channel_count, count, channel_count, gains);
+	}
+}
@@ -1,42 +1,42 @@
-#include "volumeeffect.h"
-
-#include <QGridLayout>
-#include <QLabel>
-#include <QtMath>
-#include <QDebug>
-#include <stdint.h>
-
-#include "ui/labelslider.h"
-#include "ui/collapsiblewidget.h"
-
-VolumeEffect::VolumeEffect(Clip* c) : Effect(c, EFFECT_TYPE_AUDIO, AUDIO_VOLUME_EFFECT) {
-	EffectRow* volume_row = add_row("Volume:");
-	volume_val = volume_row->add_field(EFFECT_FIELD_DOUBLE);
-	volume_val->set_double_minimum_value(0);
-	volume_val->set_double_maximum_value(400);
-
-	// set defaults
-	volume_val->set_double_default_value(100);
-
-	connect(volume_val, SIGNAL(changed()), this, SLOT(field_changed()));
-}
-
-void VolumeEffect::process_audio(double timecode_start, double timecode_end, quint8* samples, int nb_bytes, int) {
-//	qDebug() << timecode_start << timecode_end;
-	double interval = (timecode_end-timecode_start)/nb_bytes;
-	for (int i=0;i<nb_bytes;i+=2) {
-		double vol_val = volume_val->get_double_value(timecode_start+(interval*i));
-//		qDebug() << timecode_start+(interval*i);
-		qint32 samp = (qint16) (((samples[i+1] & 0xFF) << 8) | (samples[i] & 0xFF));
-		double val = qPow(vol_val*0.01, 3);
-		samp *= val;
-		if (samp > INT16_MAX) {
-			samp = INT16_MAX;
-		} else if (samp < INT16_MIN) {
-			samp = INT16_MIN;
-		}
-
-		samples[i+1] = (quint8) (samp >> 8);
-		samples[i] = (quint8) samp;
-	}
-}
+#include "volumeeffect.h"
+
+#include <QGridLayout>
+#include <QLabel>
+#include <QtMath>
+#include <QDebug>
+#include <stdint.h>
+
+#include "ui/labelslider.h"
+#include "ui/collapsiblewidget.h"
+#include "playback/audio.h"
+
+VolumeEffect::VolumeEffect(Clip* c) : Effect(c, EFFECT_TYPE_AUDIO, AUDIO_VOLUME_EFFECT) {
+	EffectRow* volume_row = add_row("Volume:");
+	volume_val = volume_row->add_field(EFFECT_FIELD_DOUBLE);
+	volume_val->set_double_minimum_value(0);
+	volume_val->set_double_maximum_value(400);
+
+	// set defaults
+	volume_val->set_double_default_value(100);
+
+	connect(volume_val, SIGNAL(changed()), this, SLOT(field_changed()));
+}
+
+void VolumeEffect::process_audio(double timecode_start, double timecode_end, quint8* samples, int nb_bytes, int channel_count) {
+	int nb_frames = nb_bytes / (channel_count << 1);
+	if (nb_frames == 0) return;
+	double interval = (timecode_end-timecode_start)/nb_frames;
+	qint16* data = reinterpret_cast<qint16*>(samples);
+
+	// gain is only worked out at block boundaries and ramped in between
+	float gain_start = qPow(volume_val->get_double_value(timecode_start)*0.01, 3);
+	int block_frames = get_block_frames(channel_count);
+	for (int i=0;i<nb_frames;i+=block_frames) {
+		int count = qMin(block_frames, nb_frames-i);
+		float gain_end = qPow(volume_val->get_double_value(timecode_start+(interval*(i+count)))*0.01, 3);
+
+		gain_samples_block(data+i*channel_count, count, channel_count, gain_start, gain_end);
+
+		gain_start = gain_end;
+	}
+}
@@ -1,13 +1,11 @@
 #include "transition.h"
 
-#include <QOpenGLFunctions>
+#include "effects/effect.h"
 
 CrossDissolveTransition::CrossDissolveTransition() : Transition(VIDEO_DISSOLVE_TRANSITION) {}
 
-void CrossDissolveTransition::process_transition(double progress) {
-    float color[4];
-    glGetFloatv(GL_CURRENT_COLOR, color);
-	glColor4f(1.0, 1.0, 1.0, color[3]*progress);
+void CrossDissolveTransition::process_transition(double progress, GLTextureCoords& coords) {
+	coords.opacity *= progress;
 }
 
 Transition* CrossDissolveTransition::copy() {
@@ -1,251 +1,342 @@
-﻿#ifndef EFFECT_H
-#define EFFECT_H
-
-#include <QObject>
-#include <QString>
-#include <QVector>
-#include <QColor>
-#include <QOpenGLFunctions>
-#include <QOpenGLShaderProgram>
-#include <QOpenGLTexture>
-class QLabel;
-class QWidget;
-class CollapsibleWidget;
-class QGridLayout;
-
-struct Clip;
-class QXmlStreamReader;
-class QXmlStreamWriter;
-class Effect;
-class EffectRow;
-class CheckboxEx;
-class KeyframeDelete;
-
-enum VideoEffects {
-	VIDEO_TRANSFORM_EFFECT,
-	VIDEO_SHAKE_EFFECT,
-	VIDEO_TEXT_EFFECT,
-	VIDEO_SOLID_EFFECT,
-	VIDEO_INVERT_EFFECT,
-	VIDEO_CHROMAKEY_EFFECT,
-	VIDEO_GAUSSIANBLUR_EFFECT,
-	VIDEO_CROP_EFFECT,
-	VIDEO_FLIP_EFFECT,
-    VIDEO_BOXBLUR_EFFECT,
-	VIDEO_EFFECT_COUNT
-};
-
-enum AudioEffects {
-	AUDIO_VOLUME_EFFECT,
-	AUDIO_PAN_EFFECT,
-	AUDIO_NOISE_EFFECT,
-	AUDIO_TONE_EFFECT,
-	AUDIO_EFFECT_COUNT
-};
-
-extern QVector<QString> video_effect_names;
-extern QVector<QString> audio_effect_names;
-void init_effects();
-Effect* create_effect(int effect_id, Clip* c);
-
-#define EFFECT_TYPE_INVALID 0
-#define EFFECT_TYPE_VIDEO 1
-#define EFFECT_TYPE_AUDIO 2
-
-#define EFFECT_FIELD_DOUBLE 0
-#define EFFECT_FIELD_COLOR 1
-#define EFFECT_FIELD_STRING 2
-#define EFFECT_FIELD_BOOL 3
-#define EFFECT_FIELD_COMBO 4
-#define EFFECT_FIELD_FONT 5
-
-#define EFFECT_KEYFRAME_LINEAR 0
-#define EFFECT_KEYFRAME_HOLD 1
-#define EFFECT_KEYFRAME_BEZIER 2
-
-struct GLTextureCoords {
-	int vertexTopLeftX;
-	int vertexTopLeftY;
-	int vertexTopRightX;
-	int vertexTopRightY;
-	int vertexBottomLeftX;
-	int vertexBottomLeftY;
-	int vertexBottomRightX;
-	int vertexBottomRightY;
-
-	double textureTopLeftX;
-	double textureTopLeftY;
-	double textureTopRightX;
-	double textureTopRightY;
-	double textureBottomRightX;
-	double textureBottomRightY;
-	double textureBottomLeftX;
-	double textureBottomLeftY;
-};
-
-qint16 mixAudioSample(qint16 a, qint16 b);
-
-class EffectField : public QObject {
-	Q_OBJECT
-public:
-    EffectField(EffectRow* parent, int t);
-    EffectRow* parent_row;
-	int type;
-
-	QVariant get_previous_data();
-    QVariant get_current_data();
-	double frameToTimecode(long frame);
-	long timecodeToFrame(double timecode);
-	void set_current_data(const QVariant&);
-	void get_keyframe_data(double timecode, int& before, int& after, double& d);
-	void validate_keyframe_data(double timecode);
-//  QVariant get_keyframe_data(long p);
-//	bool is_keyframed(long p);
-
-	double get_double_value(double timecode);
-	void set_double_value(double v);
-	void set_double_default_value(double v);
-	void set_double_minimum_value(double v);
-	void set_double_maximum_value(double v);
-
-	const QString get_string_value(double timecode);
-	void set_string_value(const QString &s);
-
-	void add_combo_item(const QString& name, const QVariant &data);
-	int get_combo_index(double timecode);
-	const QVariant get_combo_data(double timecode);
-	const QString get_combo_string(double timecode);
-	void set_combo_index(int index);
-	void set_combo_string(const QString& s);
-
-	bool get_bool_value(double timecode);
-	void set_bool_value(bool b);
-
-	const QString get_font_name(double timecode);
-	void set_font_name(const QString& s);
-
-	QColor get_color_value(double timecode);
-	void set_color_value(QColor color);
-
-	QWidget* get_ui_element();
-	void set_enabled(bool e);
-    QVector<QVariant> keyframe_data;
-	QWidget* ui_element;
-private:
-private slots:
-    void uiElementChange();
-signals:
-	void changed();
-	void toggled(bool);
-};
-
-class EffectRow : public QObject {
-    Q_OBJECT
-public:
-	EffectRow(Effect* parent, QGridLayout* uilayout, const QString& n, int row);
-	~EffectRow();
-	EffectField* add_field(int type, int colspan = 1);
-	EffectField* field(int i);
-    int fieldCount();
-	void set_keyframe_now(bool undoable);
-	void delete_keyframe(KeyframeDelete *kd, int index);
-	void delete_keyframe_at_time(KeyframeDelete* kd, long time);
-	QLabel* label;
-	Effect* parent_effect;
-
-	bool isKeyframing();
-	void setKeyframing(bool);
-
-    QVector<long> keyframe_times;
-    QVector<int> keyframe_types;
-private slots:
-	void set_keyframe_enabled(bool);
-private:
-	bool keyframing;
-	QGridLayout* ui;
-	QString name;
-	int ui_row;
-	QVector<EffectField*> fields;
-
-	CheckboxEx* keyframe_enable;
-
-	bool just_made_unsafe_keyframe;
-};
-
-class Effect : public QObject {
-	Q_OBJECT
-public:
-	Effect(Clip* c, int t, int i);
-	~Effect();
-    Clip* parent_clip;
-	int type;
-    int id;
-	QString name;
-	CollapsibleWidget* container;
-
-	EffectRow* add_row(const QString &name);
-	EffectRow* row(int i);
-	int row_count();
-
-    bool is_enabled();
-	void set_enabled(bool b);
-
-	virtual void refresh();
-
-    Effect* copy(Clip* c);
-	void copy_field_keyframes(Effect *e);
-
-    void load(QXmlStreamReader& stream);
-    void save(QXmlStreamWriter& stream);
-
-	// glsl handling
-	virtual void open();
-	virtual void close();
-	virtual void startEffect();
-	virtual void endEffect();
-
-	bool enable_shader;
-	bool enable_coords;
-	bool enable_superimpose;
-
-	int getIterations();
-	void setIterations(int i);
-
-	const char* ffmpeg_filter;
-
-	virtual void process_shader(double timecode);
-	virtual void process_coords(double timecode, GLTextureCoords& coords);
-    virtual GLuint process_superimpose(double timecode);
-	virtual void process_audio(double timecode_start, double timecode_end, quint8* samples, int nb_bytes, int channel_count);
-public slots:
-	void field_changed();
-protected:
-	QOpenGLShaderProgram* glslProgram;
-	QString vertPath;
-	QString fragPath;
-	bool isOpen;
-private:
-	QVector<EffectRow*> rows;
-	QGridLayout* ui_layout;
-	QWidget* ui;
-	int iterations;
-	bool bound;
-};
-
-class SuperimposeEffect : public Effect {
-public:
-	SuperimposeEffect(Clip* c, int t, int i);
-	virtual void open();
-	virtual void close();
-    virtual GLuint process_superimpose(double timecode);
-	virtual void redraw(double timecode);
-protected:
-	QImage img;
-	QOpenGLTexture* texture;
-	void deleteTexture();
-	bool valueHasChanged(double timecode);
-private:
-	QVector<QVariant> cachedValues;
-};
-
-#endif // EFFECT_H
+﻿#ifndef EFFECT_H
+#define EFFECT_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QList>
+#include <QByteArray>
+#include <QColor>
+#include <QImage>
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#include <QOpenGLTexture>
+#include <QMatrix4x4>
+class QLabel;
+class QWidget;
+class CollapsibleWidget;
+class QGridLayout;
+
+struct Clip;
+class QXmlStreamReader;
+class QXmlStreamWriter;
+class Effect;
+class EffectRow;
+class CheckboxEx;
+class KeyframeDelete;
+class Renderer;
+class FramebufferPool;
+class QOpenGLFramebufferObject;
+
+enum VideoEffects {
+	VIDEO_TRANSFORM_EFFECT,
+	VIDEO_SHAKE_EFFECT,
+	VIDEO_TEXT_EFFECT,
+	VIDEO_SOLID_EFFECT,
+	VIDEO_INVERT_EFFECT,
+	VIDEO_CHROMAKEY_EFFECT,
+	VIDEO_GAUSSIANBLUR_EFFECT,
+	VIDEO_CROP_EFFECT,
+	VIDEO_FLIP_EFFECT,
+    VIDEO_BOXBLUR_EFFECT,
+	VIDEO_EFFECT_COUNT
+};
+
+enum AudioEffects {
+	AUDIO_VOLUME_EFFECT,
+	AUDIO_PAN_EFFECT,
+	AUDIO_NOISE_EFFECT,
+	AUDIO_TONE_EFFECT,
+	AUDIO_EFFECT_COUNT
+};
+
+extern QVector<QString> video_effect_names;
+extern QVector<QString> audio_effect_names;
+void init_effects();
+Effect* create_effect(int effect_id, Clip* c);
+
+// compiled programs are shared by every effect using the same shaders in the current context's group.
+// clear_shader_programs() deletes the group's programs and must be called before its context goes away
+QOpenGLShaderProgram* get_shader_program(const QString& vert_path, const QString& frag_path);
+
+// one program running a chain of per-pixel snippets in order (see Effect::pointwise), cached the same way
+QOpenGLShaderProgram* get_fused_program(const QStringList& snippet_paths);
+void clear_shader_programs();
+
+// fraction of full resolution the viewer is drawing clips at, set for each frame. effects scale anything they
+// measure in pixels by it, and get_render_size() gives the size of the targets a clip's effects draw into
+extern double render_scale;
+int get_render_size(int size);
+
+// counter-based random numbers: the same seed and counter always give the same value, whatever was asked for
+// before, so effects built on them are a function of their timecode and can be drawn in any order or thread
+quint32 random_hash(quint32 seed, quint64 counter);
+
+// random_hash() spread over -1 to 1
+double random_unit(quint32 seed, quint64 counter);
+
+#define EFFECT_TYPE_INVALID 0
+#define EFFECT_TYPE_VIDEO 1
+#define EFFECT_TYPE_AUDIO 2
+
+#define EFFECT_FIELD_DOUBLE 0
+#define EFFECT_FIELD_COLOR 1
+#define EFFECT_FIELD_STRING 2
+#define EFFECT_FIELD_BOOL 3
+#define EFFECT_FIELD_COMBO 4
+#define EFFECT_FIELD_FONT 5
+
+#define EFFECT_KEYFRAME_LINEAR 0
+#define EFFECT_KEYFRAME_HOLD 1
+#define EFFECT_KEYFRAME_BEZIER 2
+
+#define BLEND_MODE_NORMAL 0
+#define BLEND_MODE_SCREEN 1
+#define BLEND_MODE_MULTIPLY 2
+#define BLEND_MODE_OVERLAY 3
+
+// everything needed to draw a clip's layer - corner positions (in sequence pixels, centered) and texture
+// coordinates, plus the transform, opacity and blend mode the coordinate effects and transitions build up
+struct GLTextureCoords {
+	int vertexTopLeftX;
+	int vertexTopLeftY;
+	int vertexTopRightX;
+	int vertexTopRightY;
+	int vertexBottomLeftX;
+	int vertexBottomLeftY;
+	int vertexBottomRightX;
+	int vertexBottomRightY;
+
+	double textureTopLeftX;
+	double textureTopLeftY;
+	double textureTopRightX;
+	double textureTopRightY;
+	double textureBottomRightX;
+	double textureBottomRightY;
+	double textureBottomLeftX;
+	double textureBottomLeftY;
+
+	QMatrix4x4 matrix;
+	float opacity;
+	int blend_mode;
+
+	GLTextureCoords();
+};
+
+qint16 mixAudioSample(qint16 a, qint16 b);
+
+class EffectField : public QObject {
+	Q_OBJECT
+public:
+    EffectField(EffectRow* parent, int t);
+    EffectRow* parent_row;
+	int type;
+
+	QVariant get_previous_data();
+    QVariant get_current_data();
+	double frameToTimecode(long frame);
+	long timecodeToFrame(double timecode);
+	void set_current_data(const QVariant&);
+	void get_keyframe_data(double timecode, int& before, int& after, double& d);
+	void validate_keyframe_data(double timecode);
+//  QVariant get_keyframe_data(long p);
+//	bool is_keyframed(long p);
+
+	double get_double_value(double timecode);
+	void set_double_value(double v);
+	void set_double_default_value(double v);
+	void set_double_minimum_value(double v);
+	void set_double_maximum_value(double v);
+
+	const QString get_string_value(double timecode);
+	void set_string_value(const QString &s);
+
+	void add_combo_item(const QString& name, const QVariant &data);
+	int get_combo_index(double timecode);
+	const QVariant get_combo_data(double timecode);
+	const QString get_combo_string(double timecode);
+	void set_combo_index(int index);
+	void set_combo_string(const QString& s);
+
+	bool get_bool_value(double timecode);
+	void set_bool_value(bool b);
+
+	const QString get_font_name(double timecode);
+	void set_font_name(const QString& s);
+
+	QColor get_color_value(double timecode);
+	void set_color_value(QColor color);
+
+	QWidget* get_ui_element();
+	void set_enabled(bool e);
+    QVector<QVariant> keyframe_data;
+	QWidget* ui_element;
+private:
+private slots:
+    void uiElementChange();
+signals:
+	void changed();
+	void toggled(bool);
+};
+
+class EffectRow : public QObject {
+    Q_OBJECT
+public:
+	EffectRow(Effect* parent, QGridLayout* uilayout, const QString& n, int row);
+	~EffectRow();
+	EffectField* add_field(int type, int colspan = 1);
+	EffectField* field(int i);
+    int fieldCount();
+	void set_keyframe_now(bool undoable);
+	void delete_keyframe(KeyframeDelete *kd, int index);
+	void delete_keyframe_at_time(KeyframeDelete* kd, long time);
+	QLabel* label;
+	Effect* parent_effect;
+
+	bool isKeyframing();
+	void setKeyframing(bool);
+
+    QVector<long> keyframe_times;
+    QVector<int> keyframe_types;
+private slots:
+	void set_keyframe_enabled(bool);
+private:
+	bool keyframing;
+	QGridLayout* ui;
+	QString name;
+	int ui_row;
+	QVector<EffectField*> fields;
+
+	CheckboxEx* keyframe_enable;
+
+	bool just_made_unsafe_keyframe;
+};
+
+class Effect : public QObject {
+	Q_OBJECT
+public:
+	Effect(Clip* c, int t, int i);
+	~Effect();
+    Clip* parent_clip;
+	int type;
+    int id;
+	QString name;
+	CollapsibleWidget* container;
+
+	EffectRow* add_row(const QString &name);
+	EffectRow* row(int i);
+	int row_count();
+
+    bool is_enabled();
+	void set_enabled(bool b);
+
+	virtual void refresh();
+
+    Effect* copy(Clip* c);
+	void copy_field_keyframes(Effect *e);
+
+    void load(QXmlStreamReader& stream);
+    void save(QXmlStreamWriter& stream);
+
+	// glsl handling
+	virtual void open();
+	virtual void close();
+	virtual void startEffect();
+	virtual void endEffect();
+
+	// the effect's shader program if it's currently bound, otherwise NULL
+	QOpenGLShaderProgram* get_program();
+
+	bool enable_shader;
+	bool enable_coords;
+	bool enable_superimpose;
+
+	// per-pixel effects whose fragPath is a snippet defining $process(), so runs of them can be fused into one pass.
+	// $ is replaced with a prefix unique to the effect's place in the chain
+	bool pointwise;
+
+	// binds a fused program for consecutive pointwise effects and sets each one's uniforms, NULL if it couldn't bind
+	static QOpenGLShaderProgram* bind_pointwise_chain(const QVector<Effect*>& chain, double timecode);
+
+	int getIterations();
+	void setIterations(int i);
+
+	// set by process_shader when the current pass samples its input below full resolution
+	bool mipmap_input;
+
+	const char* ffmpeg_filter;
+
+	virtual void process_shader(double timecode, int iteration);
+	virtual void process_coords(double timecode, GLTextureCoords& coords);
+
+	// renderer and fbo_pool belong to the context the clip is being drawn in, for effects that draw passes of their
+	// own. target is the framebuffer to bind again afterwards, NULL for the default one
+	virtual GLuint process_superimpose(double timecode, Renderer* renderer, FramebufferPool* fbo_pool, QOpenGLFramebufferObject* target);
+	virtual void process_audio(double timecode_start, double timecode_end, quint8* samples, int nb_bytes, int channel_count);
+
+	// CPU versions of process_shader() and process_superimpose() for the software renderer. process_image() turns
+	// image, the pass's input, into its output in place, and process_superimpose_image() is null if nothing is drawn.
+	// scale is what render_scale is to the viewer, the size image is drawn at against the clip's own
+	virtual void process_image(double timecode, QImage& image, int iteration, double scale);
+	virtual QImage process_superimpose_image(double timecode);
+public slots:
+	void field_changed();
+protected:
+	// effects set their uniforms through this so they land on the right names in a fused program
+	QByteArray uniform_name(const char* name);
+
+	QOpenGLShaderProgram* glslProgram;
+	QString vertPath;
+	QString fragPath;
+	bool isOpen;
+private:
+	QVector<EffectRow*> rows;
+	QGridLayout* ui_layout;
+	QWidget* ui;
+	int iterations;
+	bool bound;
+	QByteArray uniform_prefix;
+};
+
+// how many drawn images a superimpose effect keeps for field values it may come back to, and how many bytes of video
+// memory those of every superimpose effect may take up together. past the budget each one only reuses what it has
+#define SUPERIMPOSE_CACHE_SIZE 8
+#define SUPERIMPOSE_CACHE_BUDGET 268435456
+
+// bytes held by the images superimpose effects keep, textures and any targets drawn from them (GL thread only)
+extern qint64 superimpose_cache_bytes;
+
+// whether an effect already keeping count images may add another of bytes, rather than reusing its oldest. one is
+// always allowed so every effect can show something
+bool superimpose_cache_fits(int count, qint64 bytes);
+
+struct SuperimposeTexture {
+	QByteArray key;
+	QOpenGLTexture* texture;
+};
+
+class SuperimposeEffect : public Effect {
+public:
+	SuperimposeEffect(Clip* c, int t, int i);
+	virtual void close();
+	virtual GLuint process_superimpose(double timecode, Renderer* renderer, FramebufferPool* fbo_pool, QOpenGLFramebufferObject* target);
+	virtual QImage process_superimpose_image(double timecode);
+	virtual void redraw(double timecode);
+protected:
+	QImage img;
+	void deleteTexture();
+
+	// hash of every field's value and the image size at the last process_superimpose()
+	QByteArray current_key;
+private:
+	QByteArray get_key(double timecode);
+
+	// most recently used first, so redraw() only runs for values that haven't been drawn lately
+	QList<SuperimposeTexture> textures;
+
+	// key of the values img was last drawn with
+	QByteArray image_key;
+};
+
+#endif // EFFECT_H
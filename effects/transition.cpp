@@ -25,7 +25,7 @@ Transition* Transition::copy() {
 	return NULL;
 }
 
-void Transition::process_transition(double) {}
+void Transition::process_transition(double, GLTextureCoords&) {}
 void Transition::process_audio(double, double, quint8*, int, bool) {}
 
 Transition* create_transition(int transition_id, Clip* c) {
@@ -4,6 +4,7 @@
 #include <QString>
 
 struct Clip;
+struct GLTextureCoords;
 
 enum VideoTransitions {
     VIDEO_DISSOLVE_TRANSITION,
@@ -24,7 +25,7 @@ public:
 	QString name;
 	int length;
 	Transition* link;
-	virtual void process_transition(double);
+	virtual void process_transition(double, GLTextureCoords&);
 	virtual void process_audio(double, double, quint8*, int, bool);
 	virtual Transition* copy();
 };
@@ -38,7 +39,7 @@ extern QVector<QString> audio_transition_names;
 class CrossDissolveTransition : public Transition {
 public:
     CrossDissolveTransition();
-	void process_transition(double);
+	void process_transition(double, GLTextureCoords&);
     Transition* copy();
 };
 
@@ -0,0 +1,173 @@
+#include "blurkernel.h"
+
+#include "ui/softwarerenderer.h"
+
+#include <QOpenGLShaderProgram>
+#include <QImage>
+#include <QtMath>
+
+int blur_stride(int radius) {
+	// kernels wider than the taps can cover are spread out and read from a coarser mip level,
+	// so the cost of a pass stays the same however large the radius gets
+	int stride = 1;
+	while (radius > stride*BLUR_MAX_TAPS*2) stride <<= 1;
+	return stride;
+}
+
+void set_blur_pass(QOpenGLShaderProgram* program, const QVector<double>& kernel, int stride, bool horizontal, int width, int height) {
+	GLfloat weights[BLUR_MAX_TAPS+1];
+	GLfloat offsets[BLUR_MAX_TAPS+1];
+	weights[0] = 1.0;
+	offsets[0] = 0.0;
+	int taps = 0;
+
+	int radius = qMin(kernel.size()-1, BLUR_MAX_TAPS*2);
+	if (radius > 0) {
+		double sum = kernel.at(0);
+		for (int i=1;i<=radius;i++) {
+			sum += 2.0*kernel.at(i);
+		}
+
+		weights[0] = kernel.at(0)/sum;
+
+		// bilinear filtering blends two neighbouring texels in one fetch if we sample between them at the right point
+		for (int i=1;i<=radius;i+=2) {
+			double w1 = kernel.at(i);
+			double w2 = (i < radius) ? kernel.at(i+1) : 0.0;
+			taps++;
+			weights[taps] = (w1+w2)/sum;
+			offsets[taps] = (w1+w2 > 0) ? (i*w1 + (i+1)*w2)/(w1+w2) : i;
+		}
+	}
+
+	program->setUniformValue("resolution", width, height);
+	program->setUniformValue("direction", horizontal ? (GLfloat) stride : 0.0f, horizontal ? 0.0f : (GLfloat) stride);
+	program->setUniformValue("bias", (GLfloat) log2(stride));
+	program->setUniformValue("taps", taps);
+	program->setUniformValueArray("weights", weights, BLUR_MAX_TAPS+1, 1);
+	program->setUniformValueArray("offsets", offsets, BLUR_MAX_TAPS+1, 1);
+}
+
+QVector<double> gaussian_kernel(int radius, double sigma, int stride) {
+	QVector<double> kernel;
+	if (radius > 0 && sigma > 0) {
+		int strided_radius = qCeil((double) radius / stride);
+		double strided_sigma = sigma / stride;
+		for (int i=0;i<=strided_radius;i++) {
+			kernel.append(qExp(-0.5*(i/strided_sigma)*(i/strided_sigma)));
+		}
+	}
+	return kernel;
+}
+
+struct BlurJob {
+	const uchar* source;
+	uchar* target;
+	int bytes_per_line;
+	int width;
+	int height;
+	QVector<float> weights; // normalized, from the center outwards
+	bool box;
+};
+
+void blur_rows_horizontal(void* data, int first_row, int end_row) {
+	BlurJob* job = static_cast<BlurJob*>(data);
+	int radius = job->weights.size()-1;
+	int count = job->width*4;
+
+	// each row is copied out with its edge pixels repeated radius times either side, like GL_CLAMP_TO_EDGE
+	QVector<float> row((job->width + radius*2)*4);
+	QVector<double> sum(count);
+	for (int y=first_row;y<end_row;y++) {
+		const uchar* s = job->source + y*job->bytes_per_line;
+		uchar* d = job->target + y*job->bytes_per_line;
+		for (int x=0;x<row.size();x++) {
+			row[x] = s[qBound(0, (x>>2)-radius, job->width-1)*4 + (x&3)];
+		}
+
+		if (job->box) {
+			// a running total over the window, so the cost doesn't grow with the radius
+			double window[4] = {0, 0, 0, 0};
+			for (int i=0;i<radius*2*4;i++) window[i&3] += row[i];
+			for (int i=0;i<count;i++) {
+				window[i&3] += row[i+radius*2*4];
+				d[i] = float_to_byte(window[i&3]*job->weights[0]);
+				window[i&3] -= row[i];
+			}
+		} else {
+			for (int i=0;i<count;i++) sum[i] = row[radius*4+i]*job->weights[0];
+			for (int k=1;k<=radius;k++) {
+				float w = job->weights[k];
+				const float* left = row.constData() + (radius-k)*4;
+				const float* right = row.constData() + (radius+k)*4;
+				for (int i=0;i<count;i++) sum[i] += (left[i] + right[i])*w;
+			}
+			for (int i=0;i<count;i++) d[i] = float_to_byte(sum[i]);
+		}
+	}
+}
+
+void blur_rows_vertical(void* data, int first_row, int end_row) {
+	BlurJob* job = static_cast<BlurJob*>(data);
+	int radius = job->weights.size()-1;
+	int count = job->width*4;
+	int last_row = job->height-1;
+
+	QVector<double> sum(count, 0.0);
+	if (job->box) {
+		// running totals down each column, starting with the window around the band's first row
+		for (int k=first_row-radius;k<first_row+radius;k++) {
+			const uchar* s = job->source + qBound(0, k, last_row)*job->bytes_per_line;
+			for (int i=0;i<count;i++) sum[i] += s[i];
+		}
+		for (int y=first_row;y<end_row;y++) {
+			const uchar* add = job->source + qBound(0, y+radius, last_row)*job->bytes_per_line;
+			const uchar* remove = job->source + qBound(0, y-radius, last_row)*job->bytes_per_line;
+			uchar* d = job->target + y*job->bytes_per_line;
+			for (int i=0;i<count;i++) {
+				sum[i] += add[i];
+				d[i] = float_to_byte(sum[i]*job->weights[0]);
+				sum[i] -= remove[i];
+			}
+		}
+	} else {
+		for (int y=first_row;y<end_row;y++) {
+			const uchar* s = job->source + y*job->bytes_per_line;
+			for (int i=0;i<count;i++) sum[i] = s[i]*job->weights[0];
+			for (int k=1;k<=radius;k++) {
+				float w = job->weights[k];
+				const uchar* above = job->source + qMax(0, y-k)*job->bytes_per_line;
+				const uchar* below = job->source + qMin(last_row, y+k)*job->bytes_per_line;
+				for (int i=0;i<count;i++) sum[i] += (above[i] + below[i])*w;
+			}
+			uchar* d = job->target + y*job->bytes_per_line;
+			for (int i=0;i<count;i++) d[i] = float_to_byte(sum[i]);
+		}
+	}
+}
+
+void blur_image(QImage& image, const QVector<double>& kernel, bool horizontal) {
+	if (kernel.size() < 2) return;
+
+	double sum = kernel.at(0);
+	bool box = true;
+	for (int i=1;i<kernel.size();i++) {
+		sum += 2.0*kernel.at(i);
+		if (kernel.at(i) != kernel.at(0)) box = false;
+	}
+	if (sum <= 0) return;
+
+	// every pixel reads its neighbours as they were before the pass
+	QImage source = image.copy();
+
+	BlurJob job;
+	job.source = source.constBits();
+	job.target = image.bits();
+	job.bytes_per_line = image.bytesPerLine();
+	job.width = image.width();
+	job.height = image.height();
+	for (int i=0;i<kernel.size();i++) job.weights.append(kernel.at(i)/sum);
+	job.box = box;
+
+	run_in_bands(image.height(), (horizontal) ? blur_rows_horizontal : blur_rows_vertical, &job);
+}
@@ -0,0 +1,27 @@
+#ifndef BLURKERNEL_H
+#define BLURKERNEL_H
+
+#include <QVector>
+#include <QOpenGLFunctions>
+
+class QOpenGLShaderProgram;
+class QImage;
+
+// linear taps per side of a pass, also defined in separableblur.frag
+#define BLUR_MAX_TAPS 16
+
+// distance between taps needed to cover radius pixels, always a power of two so it lines up with a mip level
+int blur_stride(int radius);
+
+// sets up one pass of separableblur.frag. kernel holds the unnormalized weights from the center outwards,
+// one per stride pixels, and may have at most BLUR_MAX_TAPS*2+1 entries
+void set_blur_pass(QOpenGLShaderProgram* program, const QVector<double>& kernel, int stride, bool horizontal, int width, int height);
+
+// unnormalized gaussian weights for set_blur_pass() or blur_image(), empty if there's nothing to blur
+QVector<double> gaussian_kernel(int radius, double sigma, int stride);
+
+// one pass of separableblur.frag on the CPU, always reading every pixel rather than a mip level. the kernel is the same
+// as set_blur_pass() takes at a stride of 1 but can be any size, and boxes (all weights equal) cost the same at any radius
+void blur_image(QImage& image, const QVector<double>& kernel, bool horizontal);
+
+#endif // BLURKERNEL_H
@@ -1,25 +1,68 @@
-#include "chromakeyeffect.h"
-
-ChromaKeyEffect::ChromaKeyEffect(Clip* c) : Effect(c, EFFECT_TYPE_VIDEO, VIDEO_CHROMAKEY_EFFECT) {
-	enable_shader = true;
-
-	color_field = add_row("Color:")->add_field(EFFECT_FIELD_COLOR);
-	tolerance_field = add_row("Tolerance:")->add_field(EFFECT_FIELD_DOUBLE);
-
-	color_field->set_color_value(Qt::green);
-	tolerance_field->set_double_default_value(10);
-
-	tolerance_field->set_double_minimum_value(0);
-	tolerance_field->set_double_maximum_value(100);
-
-	vertPath = ":/shaders/common.vert";
-	fragPath = ":/shaders/chromakeyeffect.frag";
-
-	connect(color_field, SIGNAL(changed()), this, SLOT(field_changed()));
-	connect(tolerance_field, SIGNAL(changed()), this, SLOT(field_changed()));
-}
-
-void ChromaKeyEffect::process_shader(double timecode) {
-	glslProgram->setUniformValue("keyColor", color_field->get_color_value(timecode));
-	glslProgram->setUniformValue("threshold", (GLfloat) (tolerance_field->get_double_value(timecode)*0.01));
-}
+#include "chromakeyeffect.h"
+
+#include "ui/softwarerenderer.h"
+
+ChromaKeyEffect::ChromaKeyEffect(Clip* c) : Effect(c, EFFECT_TYPE_VIDEO, VIDEO_CHROMAKEY_EFFECT) {
+	enable_shader = true;
+	pointwise = true;
+
+	color_field = add_row("Color:")->add_field(EFFECT_FIELD_COLOR);
+	tolerance_field = add_row("Tolerance:")->add_field(EFFECT_FIELD_DOUBLE);
+
+	color_field->set_color_value(Qt::green);
+	tolerance_field->set_double_default_value(10);
+
+	tolerance_field->set_double_minimum_value(0);
+	tolerance_field->set_double_maximum_value(100);
+
+	vertPath = ":/shaders/common.vert";
+	fragPath = ":/shaders/chromakeyeffect.frag";
+
+	connect(color_field, SIGNAL(changed()), this, SLOT(field_changed()));
+	connect(tolerance_field, SIGNAL(changed()), this, SLOT(field_changed()));
+}
+
+void ChromaKeyEffect::process_shader(double timecode, int) {
+	glslProgram->setUniformValue(uniform_name("keyColor").constData(), color_field->get_color_value(timecode));
+	glslProgram->setUniformValue(uniform_name("threshold").constData(), (GLfloat) (tolerance_field->get_double_value(timecode)*0.01));
+}
+
+struct ChromaKeyJob {
+	uchar* bits;
+	int bytes_per_line;
+	int width;
+	float key[4];
+	float threshold;
+};
+
+void chroma_key_rows(void* data, int first_row, int end_row) {
+	ChromaKeyJob* job = static_cast<ChromaKeyJob*>(data);
+	for (int y=first_row;y<end_row;y++) {
+		quint32* p = reinterpret_cast<quint32*>(job->bits + y*job->bytes_per_line);
+		for (int x=0;x<job->width;x++) {
+			// distance to the key over all four channels, compared squared rather than taking the root
+			const uchar* c = reinterpret_cast<const uchar*>(p + x);
+			float r = c[0]*(1.0f/255.0f) - job->key[0];
+			float g = c[1]*(1.0f/255.0f) - job->key[1];
+			float b = c[2]*(1.0f/255.0f) - job->key[2];
+			float a = c[3]*(1.0f/255.0f) - job->key[3];
+			if (r*r + g*g + b*b + a*a < job->threshold) p[x] = 0;
+		}
+	}
+}
+
+void ChromaKeyEffect::process_image(double timecode, QImage& image, int, double) {
+	QColor key = color_field->get_color_value(timecode);
+	float threshold = tolerance_field->get_double_value(timecode)*0.01;
+
+	ChromaKeyJob job;
+	job.bits = image.bits();
+	job.bytes_per_line = image.bytesPerLine();
+	job.width = image.width();
+	job.key[0] = key.redF();
+	job.key[1] = key.greenF();
+	job.key[2] = key.blueF();
+	job.key[3] = key.alphaF();
+	job.threshold = threshold*threshold;
+	run_in_bands(image.height(), chroma_key_rows, &job);
+}
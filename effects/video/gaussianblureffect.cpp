@@ -1,39 +1,64 @@
-#include "gaussianblureffect.h"
-
-#include "project/clip.h"
-
-#include <QImage>
-
-GaussianBlurEffect::GaussianBlurEffect(Clip *c) : Effect(c, EFFECT_TYPE_VIDEO, VIDEO_GAUSSIANBLUR_EFFECT) {
-	enable_shader = true;
-
-    radius_val = add_row("Radius:")->add_field(EFFECT_FIELD_DOUBLE);
-    sigma_val = add_row("Sigma:")->add_field(EFFECT_FIELD_DOUBLE);
-	horiz_val = add_row("Horizontal:")->add_field(EFFECT_FIELD_BOOL);
-	vert_val = add_row("Vertical:")->add_field(EFFECT_FIELD_BOOL);
-
-    radius_val->set_double_minimum_value(0);
-    sigma_val->set_double_minimum_value(0);
-
-    radius_val->set_double_default_value(9);
-    sigma_val->set_double_default_value(5.5);
-
-	horiz_val->set_bool_value(true);
-	vert_val->set_bool_value(true);
-
-	vertPath = ":/shaders/common.vert";
-	fragPath = ":/shaders/gaussianblureffect.frag";
-
-    connect(radius_val, SIGNAL(changed()), this, SLOT(field_changed()));
-    connect(sigma_val, SIGNAL(changed()), this, SLOT(field_changed()));
-	connect(horiz_val, SIGNAL(changed()), this, SLOT(field_changed()));
-    connect(vert_val, SIGNAL(changed()), this, SLOT(field_changed()));
-}
-
-void GaussianBlurEffect::process_shader(double timecode) {
-	glslProgram->setUniformValue("resolution", parent_clip->getWidth(), parent_clip->getHeight());
-	glslProgram->setUniformValue("radius", (GLfloat) radius_val->get_double_value(timecode));
-	glslProgram->setUniformValue("sigma", (GLfloat) sigma_val->get_double_value(timecode));
-	glslProgram->setUniformValue("horiz_blur", horiz_val->get_bool_value(timecode));
-	glslProgram->setUniformValue("vert_blur", vert_val->get_bool_value(timecode));
-}
+#include "gaussianblureffect.h"
+
+#include "project/clip.h"
+#include "effects/video/blurkernel.h"
+
+#include <QImage>
+#include <QtMath>
+
+GaussianBlurEffect::GaussianBlurEffect(Clip *c) : Effect(c, EFFECT_TYPE_VIDEO, VIDEO_GAUSSIANBLUR_EFFECT) {
+	enable_shader = true;
+
+    radius_val = add_row("Radius:")->add_field(EFFECT_FIELD_DOUBLE);
+    sigma_val = add_row("Sigma:")->add_field(EFFECT_FIELD_DOUBLE);
+	horiz_val = add_row("Horizontal:")->add_field(EFFECT_FIELD_BOOL);
+	vert_val = add_row("Vertical:")->add_field(EFFECT_FIELD_BOOL);
+
+    radius_val->set_double_minimum_value(0);
+    sigma_val->set_double_minimum_value(0);
+
+    radius_val->set_double_default_value(9);
+    sigma_val->set_double_default_value(5.5);
+
+	horiz_val->set_bool_value(true);
+	vert_val->set_bool_value(true);
+
+	vertPath = ":/shaders/common.vert";
+	fragPath = ":/shaders/separableblur.frag";
+
+    connect(radius_val, SIGNAL(changed()), this, SLOT(field_changed()));
+    connect(sigma_val, SIGNAL(changed()), this, SLOT(field_changed()));
+	connect(horiz_val, SIGNAL(changed()), this, SLOT(field_changed()));
+    connect(vert_val, SIGNAL(changed()), this, SLOT(field_changed()));
+}
+
+void GaussianBlurEffect::process_shader(double timecode, int iteration) {
+	int radius = qFloor(radius_val->get_double_value(timecode)*render_scale);
+	double sigma = sigma_val->get_double_value(timecode)*render_scale;
+	bool horiz = horiz_val->get_bool_value(timecode);
+	bool vert = vert_val->get_bool_value(timecode);
+
+	// one pass per direction, the viewer checks the count again before the next pass
+	if (iteration == 0) setIterations((horiz && vert) ? 2 : 1);
+
+	QVector<double> kernel;
+	int stride = 1;
+	if (horiz || vert) {
+		stride = blur_stride(radius);
+		kernel = gaussian_kernel(radius, sigma, stride);
+	}
+
+	mipmap_input = (stride > 1);
+	set_blur_pass(glslProgram, kernel, stride, (horiz && iteration == 0), get_render_size(parent_clip->getWidth()), get_render_size(parent_clip->getHeight()));
+}
+
+void GaussianBlurEffect::process_image(double timecode, QImage& image, int iteration, double scale) {
+	int radius = qFloor(radius_val->get_double_value(timecode)*scale);
+	double sigma = sigma_val->get_double_value(timecode)*scale;
+	bool horiz = horiz_val->get_bool_value(timecode);
+	bool vert = vert_val->get_bool_value(timecode);
+
+	if (iteration == 0) setIterations((horiz && vert) ? 2 : 1);
+
+	if (horiz || vert) blur_image(image, gaussian_kernel(radius, sigma, 1), (horiz && iteration == 0));
+}
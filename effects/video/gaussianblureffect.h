@@ -1,18 +1,19 @@
-#ifndef GAUSSIANBLUREFFECT_H
-#define GAUSSIANBLUREFFECT_H
-
-#include "../effect.h"
-
-class GaussianBlurEffect : public Effect
-{
-public:
-    GaussianBlurEffect(Clip* c);
-	void process_shader(double timecode);
-private:
-    EffectField* radius_val;
-    EffectField* sigma_val;
-	EffectField* horiz_val;
-    EffectField* vert_val;
-};
-
-#endif // GAUSSIANBLUREFFECT_H
+#ifndef GAUSSIANBLUREFFECT_H
+#define GAUSSIANBLUREFFECT_H
+
+#include "../effect.h"
+
+class GaussianBlurEffect : public Effect
+{
+public:
+    GaussianBlurEffect(Clip* c);
+	void process_shader(double timecode, int iteration);
+	void process_image(double timecode, QImage& image, int iteration, double scale);
+private:
+    EffectField* radius_val;
+    EffectField* sigma_val;
+	EffectField* horiz_val;
+    EffectField* vert_val;
+};
+
+#endif // GAUSSIANBLUREFFECT_H
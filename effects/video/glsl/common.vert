@@ -1,8 +1,20 @@
-#version 110
-
-varying vec2 vTexCoord;
-
-void main() {
-    vTexCoord = gl_MultiTexCoord0.xy;
-    gl_Position = gl_ModelViewProjectionMatrix * gl_Vertex;
+#version 110
+
+// shared by every shader drawn through the renderer - a unit quad is stretched over the four corners
+uniform mat4 mvp_matrix;
+uniform vec2 vertex_corners[4]; // top left, top right, bottom right, bottom left
+uniform vec2 texture_corners[4];
+
+attribute vec2 position;
+
+varying vec2 vTexCoord;
+
+void main() {
+	vec2 vertex_top = mix(vertex_corners[0], vertex_corners[1], position.x);
+	vec2 vertex_bottom = mix(vertex_corners[3], vertex_corners[2], position.x);
+	vec2 texture_top = mix(texture_corners[0], texture_corners[1], position.x);
+	vec2 texture_bottom = mix(texture_corners[3], texture_corners[2], position.x);
+
+	vTexCoord = mix(texture_top, texture_bottom, position.y);
+	gl_Position = mvp_matrix * vec4(mix(vertex_top, vertex_bottom, position.y), 0.0, 1.0);
 }
\ No newline at end of file
@@ -0,0 +1,10 @@
+#version 110
+
+uniform sampler2D myTexture;
+uniform float opacity;
+varying vec2 vTexCoord;
+
+void main(void) {
+	vec4 textureColor = texture2D(myTexture, vTexCoord);
+	gl_FragColor = vec4(textureColor.rgb, textureColor.a * opacity);
+}
\ No newline at end of file
@@ -0,0 +1,7 @@
+#version 110
+
+uniform vec4 color;
+
+void main(void) {
+	gl_FragColor = color;
+}
\ No newline at end of file
@@ -0,0 +1,8 @@
+#version 110
+
+uniform mat4 mvp_matrix;
+attribute vec2 position;
+
+void main() {
+	gl_Position = mvp_matrix * vec4(position, 0.0, 1.0);
+}
\ No newline at end of file
@@ -0,0 +1,29 @@
+#version 110
+
+// must match BLUR_MAX_TAPS in blurkernel.h
+#define MAX_TAPS 16
+
+uniform sampler2D image;
+
+uniform vec2 resolution;
+uniform vec2 direction; // distance between taps in pixels along this pass
+// added to the mip level the texture would be read at, so wide kernels read prefiltered texels. passes are drawn 1:1
+// with their input, where that level is 0, so this ends up being the level matching the tap distance
+uniform float bias;
+uniform int taps;
+uniform float weights[MAX_TAPS+1]; // weights[0] is the center, the rest are each a pair of texels merged into one linear tap
+uniform float offsets[MAX_TAPS+1];
+
+void main(void) {
+	vec2 coord = gl_FragCoord.xy/resolution;
+	vec4 color = texture2D(image, coord, bias)*weights[0];
+
+	for (int i=1;i<=MAX_TAPS;i++) {
+		if (i > taps) break;
+		vec2 offset = (direction*offsets[i])/resolution;
+		color += texture2D(image, coord+offset, bias)*weights[i];
+		color += texture2D(image, coord-offset, bias)*weights[i];
+	}
+
+	gl_FragColor = color;
+}
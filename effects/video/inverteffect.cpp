@@ -1,31 +1,63 @@
-#include "inverteffect.h"
-
-#include "ui/labelslider.h"
-
-#include <QLabel>
-#include <QGridLayout>
-#include <QOpenGLFunctions>
-#include <QXmlStreamReader>
-#include <QXmlStreamWriter>
-#include <QXmlStreamAttributes>
-
-InvertEffect::InvertEffect(Clip* c) : Effect(c, EFFECT_TYPE_VIDEO, VIDEO_INVERT_EFFECT) {
-	enable_shader = true;
-
-	EffectRow* amount_row = add_row("Amount:");
-	amount_val = amount_row->add_field(EFFECT_FIELD_DOUBLE);
-	amount_val->set_double_minimum_value(0);
-	amount_val->set_double_maximum_value(100);
-
-	// set defaults	
-	amount_val->set_double_default_value(100);
-
-	connect(amount_val, SIGNAL(changed()), this, SLOT(field_changed()));
-
-	vertPath = ":/shaders/common.vert";
-	fragPath = ":/shaders/inverteffect.frag";
-}
-
-void InvertEffect::process_shader(double timecode) {
-	glslProgram->setUniformValue("amount_val", (GLfloat) (amount_val->get_double_value(timecode)*0.01));
-}
+#include "inverteffect.h"
+
+#include "ui/labelslider.h"
+#include "ui/softwarerenderer.h"
+
+#include <QLabel>
+#include <QGridLayout>
+#include <QOpenGLFunctions>
+#include <QXmlStreamReader>
+#include <QXmlStreamWriter>
+#include <QXmlStreamAttributes>
+
+InvertEffect::InvertEffect(Clip* c) : Effect(c, EFFECT_TYPE_VIDEO, VIDEO_INVERT_EFFECT) {
+	enable_shader = true;
+	pointwise = true;
+
+	EffectRow* amount_row = add_row("Amount:");
+	amount_val = amount_row->add_field(EFFECT_FIELD_DOUBLE);
+	amount_val->set_double_minimum_value(0);
+	amount_val->set_double_maximum_value(100);
+
+	// set defaults	
+	amount_val->set_double_default_value(100);
+
+	connect(amount_val, SIGNAL(changed()), this, SLOT(field_changed()));
+
+	vertPath = ":/shaders/common.vert";
+	fragPath = ":/shaders/inverteffect.frag";
+}
+
+void InvertEffect::process_shader(double timecode, int) {
+	glslProgram->setUniformValue(uniform_name("amount_val").constData(), (GLfloat) (amount_val->get_double_value(timecode)*0.01));
+}
+
+struct InvertJob {
+	uchar* bits;
+	int bytes_per_line;
+	int width;
+	float amount;
+};
+
+void invert_rows(void* data, int first_row, int end_row) {
+	InvertJob* job = static_cast<InvertJob*>(data);
+	for (int y=first_row;y<end_row;y++) {
+		uchar* p = job->bits + y*job->bytes_per_line;
+		for (int x=0;x<job->width;x++) {
+			// alpha is left alone, the same as in inverteffect.frag
+			for (int c=0;c<3;c++) {
+				float v = p[x*4+c];
+				p[x*4+c] = float_to_byte(v + (255.0f - v - v)*job->amount);
+			}
+		}
+	}
+}
+
+void InvertEffect::process_image(double timecode, QImage& image, int, double) {
+	InvertJob job;
+	job.bits = image.bits();
+	job.bytes_per_line = image.bytesPerLine();
+	job.width = image.width();
+	job.amount = amount_val->get_double_value(timecode)*0.01;
+	run_in_bands(image.height(), invert_rows, &job);
+}
@@ -1,15 +1,16 @@
-#ifndef INVERTEFFECT_H
-#define INVERTEFFECT_H
-
-#include "../effect.h"
-
-class InvertEffect : public Effect {
-	Q_OBJECT
-public:
-	InvertEffect(Clip* c);
-	void process_shader(double timecode);
-private:
-	EffectField* amount_val;
-};
-
-#endif // INVERTEFFECT_H
+#ifndef INVERTEFFECT_H
+#define INVERTEFFECT_H
+
+#include "../effect.h"
+
+class InvertEffect : public Effect {
+	Q_OBJECT
+public:
+	InvertEffect(Clip* c);
+	void process_shader(double timecode, int iteration);
+	void process_image(double timecode, QImage& image, int iteration, double scale);
+private:
+	EffectField* amount_val;
+};
+
+#endif // INVERTEFFECT_H
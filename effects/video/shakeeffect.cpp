@@ -3,16 +3,13 @@
 #include <QGridLayout>
 #include <QLabel>
 #include <QtMath>
-#include <QOpenGLFunctions>
 #include <QDebug>
 
 #include "ui/labelslider.h"
 #include "ui/collapsiblewidget.h"
 #include "project/clip.h"
-#include "project/sequence.h"
-#include "panels/timeline.h"
 
-ShakeEffect::ShakeEffect(Clip *c) : Effect(c, EFFECT_TYPE_VIDEO, VIDEO_SHAKE_EFFECT), inside(false) {
+ShakeEffect::ShakeEffect(Clip *c) : Effect(c, EFFECT_TYPE_VIDEO, VIDEO_SHAKE_EFFECT) {
 	enable_coords = true;
 
 	EffectRow* intensity_row = add_row("Intensity:");
@@ -27,82 +24,53 @@ ShakeEffect::ShakeEffect(Clip *c) : Effect(c, EFFECT_TYPE_VIDEO, VIDEO_SHAKE_EFF
 	frequency_val = frequency_row->add_field(EFFECT_FIELD_DOUBLE);
 	frequency_val->set_double_minimum_value(0);
 
+	seed_val = add_row("Seed:")->add_field(EFFECT_FIELD_DOUBLE);
+	seed_val->set_double_minimum_value(0);
+
     // set defaults
 	intensity_val->set_double_default_value(50);
 	rotation_val->set_double_default_value(0);
 	frequency_val->set_double_default_value(10);
 
-	refresh();
+	// every new shake moves differently, the seed is saved with the project so it stays the same from then on
+	seed_val->set_double_default_value(qrand() % 10000);
 
 	connect(intensity_val, SIGNAL(changed()), this, SLOT(field_changed()));
 	connect(rotation_val, SIGNAL(changed()), this, SLOT(field_changed()));
 	connect(frequency_val, SIGNAL(changed()), this, SLOT(field_changed()));
+	connect(seed_val, SIGNAL(changed()), this, SLOT(field_changed()));
 }
 
-void ShakeEffect::refresh() {
-    if (parent_clip->sequence != NULL) {
-		shake_limit = qRound(parent_clip->sequence->frame_rate / frequency_val->get_double_value(-1));
-        shake_progress = shake_limit;
-        next_x = 0;
-        next_y = 0;
-        next_rot = 0;
-    }
-}
-
-void ShakeEffect::process_coords(double timecode, GLTextureCoords&) {
-    if (shake_progress > shake_limit) {
-		double ival = intensity_val->get_double_value(timecode);
-		if ((int)ival > 0) {
-            prev_x = next_x;
-            prev_y = next_y;
-			next_x = (qrand() % (int) (ival * 2)) - ival;
-			next_y = (qrand() % (int) (ival * 2)) - ival;
-
-            // find perpendicular slope that passes through (mid_x, mid_y)
-            int mid_x = (prev_x + next_x) / 2;
-            int mid_y = (prev_y + next_y) / 2;
-            int slope_num = (next_y-prev_y);
-            if (slope_num > 0) {
-                int slope_den = (next_x-prev_x);
-                int add = (next_x-prev_x)/4;
-                if (inside) add = -add;
-                inside = !inside;
-                perp_x = mid_x + add;
-                perp_y = (-(slope_den / slope_num)) * perp_x + mid_y;
-            } else {
-                perp_x = mid_x;
-                perp_y = mid_y;
-            }
-        } else {
-            prev_x = 0;
-            prev_y = 0;
-            next_x = 0;
-            next_y = 0;
-            offset_x = 0;
-            offset_y = 0;
-        }
-		double rot_val = rotation_val->get_double_value(timecode);
-		if ((int)rot_val > 0) {
-            prev_rot = next_rot;
-			next_rot = (qrand() % (int) (rot_val * 2)) - rot_val;
-        } else {
-            prev_rot = 0;
-            next_rot = 0;
-            offset_rot = 0;
-        }
-        shake_progress = 0;
-    }
-
-    t = (double) shake_progress / (double) shake_limit;
-
-    double oneminust = 1 - t;
-
-    offset_x = (qPow(oneminust, 2)*prev_x) + (2*oneminust*t*perp_x) + (qPow(t, 2) * next_x);
-    offset_y = (qPow(oneminust, 2)*prev_y) + (2*oneminust*t*perp_y) + (qPow(t, 2) * next_y);
-
-    offset_rot = lerp(prev_rot, next_rot, t);
-
-    glTranslatef(offset_x, offset_y, 0);
-    glRotatef(offset_rot, 0, 0, 1);
-    shake_progress++;
+void ShakeEffect::process_coords(double timecode, GLTextureCoords& coords) {
+	double frequency = frequency_val->get_double_value(timecode);
+	if (frequency <= 0) return;
+
+	// the shake moves between random points, one every 1/frequency seconds. each point depends only on the seed
+	// and its index, so any frame can be drawn on its own, in any order, and always comes out the same
+	quint32 seed = qRound(seed_val->get_double_value(timecode));
+	double position = timecode * frequency;
+	qint64 segment = qFloor(position);
+	double t = position - segment;
+
+	double prev_x = random_unit(seed, segment*3);
+	double prev_y = random_unit(seed, segment*3+1);
+	double next_x = random_unit(seed, (segment+1)*3);
+	double next_y = random_unit(seed, (segment+1)*3+1);
+
+	// curve through a control point off to the side of the straight path, alternating sides every segment
+	double side = (segment & 1) ? -0.25 : 0.25;
+	double perp_x = (prev_x + next_x) * 0.5 - (next_y - prev_y) * side;
+	double perp_y = (prev_y + next_y) * 0.5 + (next_x - prev_x) * side;
+
+	double oneminust = 1 - t;
+	double ival = intensity_val->get_double_value(timecode);
+	double offset_x = ((oneminust*oneminust*prev_x) + (2*oneminust*t*perp_x) + (t*t*next_x)) * ival;
+	double offset_y = ((oneminust*oneminust*prev_y) + (2*oneminust*t*perp_y) + (t*t*next_y)) * ival;
+
+	double prev_rot = random_unit(seed, segment*3+2);
+	double next_rot = random_unit(seed, (segment+1)*3+2);
+	double offset_rot = (prev_rot + (next_rot - prev_rot)*t) * rotation_val->get_double_value(timecode);
+
+	coords.matrix.translate(offset_x, offset_y);
+	coords.matrix.rotate(offset_rot, 0, 0, 1);
 }
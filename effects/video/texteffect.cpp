@@ -3,6 +3,8 @@
 #include <QGridLayout>
 #include <QLabel>
 #include <QOpenGLTexture>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLShaderProgram>
 #include <QTextEdit>
 #include <QPainter>
 #include <QPushButton>
@@ -11,6 +13,7 @@
 #include <QComboBox>
 #include <QDebug>
 #include <QWidget>
+#include <QtMath>
 
 #include "ui/labelslider.h"
 #include "ui/collapsiblewidget.h"
@@ -19,9 +22,16 @@
 #include "ui/comboboxex.h"
 #include "ui/colorbutton.h"
 #include "ui/fontcombobox.h"
+#include "ui/renderer.h"
+#include "ui/framebufferpool.h"
+#include "ui/softwarerenderer.h"
+#include "effects/video/blurkernel.h"
 
 TextEffect::TextEffect(Clip *c) :
-	SuperimposeEffect(c, EFFECT_TYPE_VIDEO, VIDEO_TEXT_EFFECT)
+	SuperimposeEffect(c, EFFECT_TYPE_VIDEO, VIDEO_TEXT_EFFECT),
+	shadow_texture(NULL),
+	shadow_uploaded(false),
+	composite_pool(NULL)
 {
 	enable_superimpose = true;
 
@@ -98,83 +108,22 @@ TextEffect::TextEffect(Clip *c) :
 	connect(outline_bool, SIGNAL(toggled(bool)), this, SLOT(outline_enable(bool)));
 }
 
-void blurred2(QImage& result, const QRect& rect, int radius, bool alphaOnly = false) {
-	int tab[] = { 14, 10, 8, 6, 5, 5, 4, 3, 3, 3, 3, 2, 2, 2, 2, 2, 2 };
-	int alpha = (radius < 1)  ? 16 : (radius > 17) ? 1 : tab[radius-1];
-
-	int r1 = rect.top();
-	int r2 = rect.bottom();
-	int c1 = rect.left();
-	int c2 = rect.right();
-
-	int bpl = result.bytesPerLine();
-	int rgba[4];
-	unsigned char* p;
-
-	int i1 = 0;
-	int i2 = 3;
-
-	if (alphaOnly)
-		i1 = i2 = (QSysInfo::ByteOrder == QSysInfo::BigEndian ? 0 : 3);
-
-	for (int col = c1; col <= c2; col++) {
-		p = result.scanLine(r1) + col * 4;
-		for (int i = i1; i <= i2; i++)
-			rgba[i] = p[i] << 4;
-
-		p += bpl;
-		for (int j = r1; j < r2; j++, p += bpl)
-			for (int i = i1; i <= i2; i++)
-				p[i] = (rgba[i] += ((p[i] << 4) - rgba[i]) * alpha / 16) >> 4;
-	}
-
-	for (int row = r1; row <= r2; row++) {
-		p = result.scanLine(row) + c1 * 4;
-		for (int i = i1; i <= i2; i++)
-			rgba[i] = p[i] << 4;
-
-		p += 4;
-		for (int j = c1; j < c2; j++, p += 4)
-			for (int i = i1; i <= i2; i++)
-				p[i] = (rgba[i] += ((p[i] << 4) - rgba[i]) * alpha / 16) >> 4;
-	}
-
-	for (int col = c1; col <= c2; col++) {
-		p = result.scanLine(r2) + col * 4;
-		for (int i = i1; i <= i2; i++)
-			rgba[i] = p[i] << 4;
-
-		p -= bpl;
-		for (int j = r1; j < r2; j++, p -= bpl)
-			for (int i = i1; i <= i2; i++)
-				p[i] = (rgba[i] += ((p[i] << 4) - rgba[i]) * alpha / 16) >> 4;
-	}
-
-	for (int row = r1; row <= r2; row++) {
-		p = result.scanLine(row) + c2 * 4;
-		for (int i = i1; i <= i2; i++)
-			rgba[i] = p[i] << 4;
-
-		p -= 4;
-		for (int j = c1; j < c2; j++, p -= 4)
-			for (int i = i1; i <= i2; i++)
-				p[i] = (rgba[i] += ((p[i] << 4) - rgba[i]) * alpha / 16) >> 4;
-	}
-}
-
-void TextEffect::redraw(double timecode) {
-	img.fill(Qt::transparent);
-
-	QPainter p(&img);
-	p.setRenderHint(QPainter::Antialiasing);
+void TextEffect::update_layout(double timecode) {
 	int width = img.width();
 	int height = img.height();
 
+	// colours, outlines and shadows reuse the same path, only changes that move the glyphs lay it out again
+	QVector<QVariant> values;
+	values << text_val->get_string_value(timecode) << set_font_combobox->get_font_name(timecode) << size_val->get_double_value(timecode)
+		   << halign_field->get_combo_data(timecode) << valign_field->get_combo_data(timecode) << word_wrap_field->get_bool_value(timecode)
+		   << width << height;
+	if (values == layout_values) return;
+	layout_values = values;
+
 	// set font
 	font.setStyleHint(QFont::Helvetica, QFont::PreferAntialias);
 	font.setFamily(set_font_combobox->get_font_name(timecode));
 	font.setPointSize(size_val->get_double_value(timecode));
-	p.setFont(font);
 	QFontMetrics fm(font);
 
 	QStringList lines = text_val->get_string_value(timecode).split('\n');
@@ -184,13 +133,18 @@ void TextEffect::redraw(double timecode) {
 		for (int i=0;i<lines.size();i++) {
 			QString s(lines.at(i));
 			if (fm.width(s) > width) {
+				// measured a word at a time, so each character is only measured once per line it lands on
 				int last_space_index = 0;
+				int line_width = 0;
+				int word_start = 0;
 				for (int j=0;j<s.length();j++) {
 					if (s.at(j) == ' ') {
-						if (fm.width(s.left(j)) > width) {
+						line_width += fm.width(s.mid(word_start, j - word_start));
+						if (line_width > width) {
 							break;
 						} else {
 							last_space_index = j;
+							word_start = j;
 						}
 					}
 				}
@@ -202,7 +156,7 @@ void TextEffect::redraw(double timecode) {
 		}
 	}
 
-	QPainterPath path;
+	text_path = QPainterPath();
 
 	int text_height = fm.height()*lines.size();
 
@@ -244,26 +198,18 @@ void TextEffect::redraw(double timecode) {
 		case Qt::AlignBottom: text_y = (height - text_height - fm.descent()) + (fm.height()*(i+1)); break;
 		}
 
-		path.addText(text_x, text_y, font, lines.at(i));
+		text_path.addText(text_x, text_y, font, lines.at(i));
 	}
+}
 
-	p.setPen(Qt::NoPen);
-
-	// draw shadow
-	if (shadow_bool->get_bool_value(timecode)) {
-		int shadow_offset = shadow_distance->get_double_value(timecode);
-
-		QPainterPath shadow_path(path);
-		shadow_path.translate(shadow_offset, shadow_offset);
+void TextEffect::redraw(double timecode) {
+	update_layout(timecode);
 
-		QColor col = shadow_color->get_color_value(timecode);
-		col.setAlphaF(shadow_opacity->get_double_value(timecode)*0.01);
-		p.setBrush(col);
-		p.drawPath(shadow_path);
+	img.fill(Qt::transparent);
 
-		int blurSoftness = shadow_softness->get_double_value(timecode);
-		if (blurSoftness > 0) blurred2(img, img.rect(), blurSoftness, false);
-	}
+	QPainter p(&img);
+	p.setRenderHint(QPainter::Antialiasing);
+	p.setPen(Qt::NoPen);
 
 	// draw outline
 	int outline_width_val = outline_width->get_double_value(timecode);
@@ -275,7 +221,172 @@ void TextEffect::redraw(double timecode) {
 
 	// draw "master" text
 	p.setBrush(set_color_button->get_color_value(timecode));
-	p.drawPath(path);
+	p.drawPath(text_path);
+	p.end();
+}
+
+GLuint TextEffect::process_superimpose(double timecode, Renderer* renderer, FramebufferPool* fbo_pool, QOpenGLFramebufferObject* target) {
+	GLuint text_texture = SuperimposeEffect::process_superimpose(timecode, renderer, fbo_pool, target);
+	if (text_texture == 0 || !shadow_bool->get_bool_value(timecode)) return text_texture;
+	return draw_shadow(timecode, text_texture, renderer, fbo_pool, target);
+}
+
+void TextEffect::paint_shadow(double timecode) {
+	update_layout(timecode);
+
+	int shadow_offset = shadow_distance->get_double_value(timecode);
+	QColor col = shadow_color->get_color_value(timecode);
+	col.setAlphaF(shadow_opacity->get_double_value(timecode)*0.01);
+
+	// the sharp shape is only repainted if it moved or changed colour, softness is left to the blur
+	QVector<QVariant> values(layout_values);
+	values << col << shadow_offset;
+	if (values == shadow_values) return;
+	shadow_values = values;
+	shadow_uploaded = false;
+
+	shadow_img = QImage(img.size(), QImage::Format_RGBA8888);
+
+	// transparent pixels keep the shadow's colour so blurring its edges doesn't darken them
+	QColor clear(col);
+	clear.setAlpha(0);
+	shadow_img.fill(clear);
+
+	QPainter p(&shadow_img);
+	p.setRenderHint(QPainter::Antialiasing);
+	p.setPen(Qt::NoPen);
+	p.setBrush(col);
+	p.drawPath(text_path.translated(shadow_offset, shadow_offset));
+	p.end();
+}
+
+GLuint TextEffect::draw_shadow(double timecode, GLuint text_texture, Renderer* renderer, FramebufferPool* fbo_pool, QOpenGLFramebufferObject* target) {
+	int width = img.width();
+	int height = img.height();
+
+	if (!composites.isEmpty() && composites.first().fbo->size() != img.size()) give_back_composites();
+	composite_pool = fbo_pool;
+
+	// composites are keyed by the same field values as the text image under them
+	for (int i=0;i<composites.size();i++) {
+		if (composites.at(i).key == current_key) {
+			composites.move(i, 0);
+			return composites.first().fbo->texture();
+		}
+	}
+
+	paint_shadow(timecode);
+
+	// the software renderer paints the shadow without uploading it, so this checks its own flag rather than the values
+	if (!shadow_uploaded) {
+		if (shadow_texture == NULL || shadow_texture->width() != shadow_img.width() || shadow_texture->height() != shadow_img.height()) {
+			delete shadow_texture;
+			shadow_texture = new QOpenGLTexture(shadow_img);
+		} else {
+			shadow_texture->setData(0, QOpenGLTexture::RGBA, QOpenGLTexture::UInt8, shadow_img.constBits());
+		}
+		shadow_uploaded = true;
+	}
+
+	TextComposite entry;
+	entry.key = current_key;
+	qint64 bytes = (qint64) width * height * 4;
+	if (superimpose_cache_fits(composites.size(), bytes)) {
+		entry.fbo = fbo_pool->acquire(width, height);
+		fbo_pool->retain(entry.fbo);
+		superimpose_cache_bytes += bytes;
+	} else {
+		entry.fbo = composites.takeLast().fbo;
+	}
+
+	QMatrix4x4 projection;
+	projection.ortho(0, 1, 0, 1, -1, 1);
+
+	GLTextureCoords coords;
+	coords.vertexTopLeftX = coords.vertexBottomLeftX = coords.vertexTopLeftY = coords.vertexTopRightY = 0;
+	coords.vertexTopRightX = coords.vertexBottomRightX = coords.vertexBottomLeftY = coords.vertexBottomRightY = 1;
+	coords.textureTopLeftX = coords.textureBottomLeftX = coords.textureTopLeftY = coords.textureTopRightY = 0;
+	coords.textureTopRightX = coords.textureBottomRightX = coords.textureBottomLeftY = coords.textureBottomRightY = 1;
+
+	// gaussian roughly as soft as the old cpu blur at the same setting
+	double sigma = shadow_softness->get_double_value(timecode)*0.75;
+	int radius = qCeil(sigma*3);
+	int stride = blur_stride(radius);
+	QVector<double> kernel = gaussian_kernel(radius, sigma, stride);
+
+	// the effect's own targets are always full size, whatever size the clip is being drawn at
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	glViewport(0, 0, width, height);
+
+	// the blur and the copy under the text replace what's in the target rather than blending into it
+	glDisable(GL_BLEND);
+
+	GLuint shadow = shadow_texture->textureId();
+	QOpenGLFramebufferObject* shadow_fbo[2] = {NULL, NULL};
+	QOpenGLShaderProgram* blur = get_shader_program(":/shaders/common.vert", ":/shaders/separableblur.frag");
+	if (!kernel.isEmpty() && blur->bind()) {
+		for (int i=0;i<2;i++) {
+			shadow_fbo[i] = fbo_pool->acquire(width, height);
+			set_blur_pass(blur, kernel, stride, (i == 0), width, height);
+			shadow_fbo[i]->bind();
+			renderer->draw_quad(shadow, projection, coords, blur, stride > 1);
+			shadow_fbo[i]->release();
+			shadow = shadow_fbo[i]->texture();
+		}
+		blur->release();
+	}
+
+	entry.fbo->bind();
+	renderer->draw_quad(shadow, projection, coords);
+	glEnable(GL_BLEND);
+	renderer->draw_quad(text_texture, projection, coords);
+	entry.fbo->release();
+
+	if (target != NULL) target->bind();
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+	// the draws above have been queued, so the blur targets can go to whoever borrows next
+	for (int i=0;i<2;i++) {
+		if (shadow_fbo[i] != NULL) fbo_pool->give_back(shadow_fbo[i]);
+	}
+
+	composites.prepend(entry);
+	return entry.fbo->texture();
+}
+
+QImage TextEffect::process_superimpose_image(double timecode) {
+	QImage text = SuperimposeEffect::process_superimpose_image(timecode);
+	if (!shadow_bool->get_bool_value(timecode)) return text;
+
+	paint_shadow(timecode);
+
+	// the same passes as draw_shadow(), blurring at full resolution
+	double sigma = shadow_softness->get_double_value(timecode)*0.75;
+	QVector<double> kernel = gaussian_kernel(qCeil(sigma*3), sigma, 1);
+	QImage composite = shadow_img.copy();
+	blur_image(composite, kernel, true);
+	blur_image(composite, kernel, false);
+	blend_image(composite, text, BLEND_MODE_NORMAL);
+	return composite;
+}
+
+void TextEffect::give_back_composites() {
+	for (int i=0;i<composites.size();i++) {
+		QOpenGLFramebufferObject* fbo = composites.at(i).fbo;
+		superimpose_cache_bytes -= (qint64) fbo->width() * fbo->height() * 4;
+		composite_pool->give_back(fbo);
+	}
+	composites.clear();
+}
+
+void TextEffect::close() {
+	SuperimposeEffect::close();
+	delete shadow_texture;
+	shadow_texture = NULL;
+	shadow_uploaded = false;
+	shadow_values.clear();
+	give_back_composites();
 }
 
 void TextEffect::shadow_enable(bool e) {
@@ -1,40 +1,76 @@
-#ifndef TEXTEFFECT_H
-#define TEXTEFFECT_H
-
-#include "../effect.h"
-
-#include <QFont>
-#include <QImage>
-class QOpenGLTexture;
-
-class TextEffect : public SuperimposeEffect {
-	Q_OBJECT
-public:
-	TextEffect(Clip* c);
-	void redraw(double timecode);
-
-	EffectField* text_val;
-	EffectField* size_val;
-	EffectField* set_color_button;
-	EffectField* set_font_combobox;
-	EffectField* halign_field;
-	EffectField* valign_field;
-	EffectField* word_wrap_field;
-
-	EffectField* outline_bool;
-	EffectField* outline_width;
-	EffectField* outline_color;
-
-	EffectField* shadow_bool;
-	EffectField* shadow_distance;
-	EffectField* shadow_color;
-	EffectField* shadow_softness;
-	EffectField* shadow_opacity;
-private slots:
-	void outline_enable(bool);
-	void shadow_enable(bool);
-private:
-	QFont font;
-};
-
-#endif // TEXTEFFECT_H
+#ifndef TEXTEFFECT_H
+#define TEXTEFFECT_H
+
+#include "../effect.h"
+
+#include <QFont>
+#include <QImage>
+#include <QPainterPath>
+#include <QVector>
+#include <QList>
+#include <QVariant>
+class QOpenGLTexture;
+class QOpenGLFramebufferObject;
+class Renderer;
+class FramebufferPool;
+
+struct TextComposite {
+	QByteArray key;
+	QOpenGLFramebufferObject* fbo;
+};
+
+class TextEffect : public SuperimposeEffect {
+	Q_OBJECT
+public:
+	TextEffect(Clip* c);
+	void redraw(double timecode);
+	GLuint process_superimpose(double timecode, Renderer* renderer, FramebufferPool* fbo_pool, QOpenGLFramebufferObject* target);
+	QImage process_superimpose_image(double timecode);
+	void close();
+
+	EffectField* text_val;
+	EffectField* size_val;
+	EffectField* set_color_button;
+	EffectField* set_font_combobox;
+	EffectField* halign_field;
+	EffectField* valign_field;
+	EffectField* word_wrap_field;
+
+	EffectField* outline_bool;
+	EffectField* outline_width;
+	EffectField* outline_color;
+
+	EffectField* shadow_bool;
+	EffectField* shadow_distance;
+	EffectField* shadow_color;
+	EffectField* shadow_softness;
+	EffectField* shadow_opacity;
+private slots:
+	void outline_enable(bool);
+	void shadow_enable(bool);
+private:
+	void update_layout(double timecode);
+	void paint_shadow(double timecode);
+	GLuint draw_shadow(double timecode, GLuint text_texture, Renderer* renderer, FramebufferPool* fbo_pool, QOpenGLFramebufferObject* target);
+	void give_back_composites();
+
+	QFont font;
+
+	// the text laid out as a path, kept until something that moves the glyphs changes
+	QPainterPath text_path;
+	QVector<QVariant> layout_values;
+
+	// the shadow is painted sharp and blurred on the gpu through targets borrowed from the viewer's pool, then the
+	// text is drawn over it
+	QImage shadow_img;
+	QVector<QVariant> shadow_values;
+	QOpenGLTexture* shadow_texture;
+	bool shadow_uploaded; // false until shadow_texture holds shadow_img as it's painted now
+
+	// finished composites for recent field values, most recently used first like SuperimposeEffect's images. they're
+	// retained in composite_pool until the effect closes or they're drawn at another size
+	QList<TextComposite> composites;
+	FramebufferPool* composite_pool;
+};
+
+#endif // TEXTEFFECT_H
@@ -1,37 +1,50 @@
-#ifndef CONFIG_H
-#define CONFIG_H
-
-#include <QString>
-
-#define SAVE_VERSION "180820" // YYMMDD
-
-#define TIMECODE_DROP 0
-#define TIMECODE_NONDROP 1
-#define TIMECODE_FRAMES 2
-
-struct Config {
-    Config();
-    bool saved_layout;
-    bool show_track_lines;
-    bool scroll_zooms;
-    bool edit_tool_selects_links;
-    bool edit_tool_also_seeks;
-    bool select_also_seeks;
-    bool paste_seeks;
-    QString img_seq_formats;
-	bool rectified_waveforms;
-	int default_transition_length;
-    int timecode_view;
-    bool show_title_safe_area;
-    bool use_custom_title_safe_ratio;
-    double custom_title_safe_ratio;
-	bool enable_drag_files_to_timeline;
-    bool autoscale_by_default;
-
-    void load(QString path);
-    void save(QString path);
-};
-
-extern Config config;
-
-#endif // CONFIG_H
+#ifndef CONFIG_H
+#define CONFIG_H
+
+#include <QString>
+
+#define SAVE_VERSION "180820" // YYMMDD
+
+#define TIMECODE_DROP 0
+#define TIMECODE_NONDROP 1
+#define TIMECODE_FRAMES 2
+
+#define PLAYBACK_RESOLUTION_FULL 0
+#define PLAYBACK_RESOLUTION_HALF 1
+#define PLAYBACK_RESOLUTION_QUARTER 2
+#define PLAYBACK_RESOLUTION_AUTO 3 // half while playing, full when paused
+
+struct Config {
+    Config();
+    bool saved_layout;
+    bool show_track_lines;
+    bool scroll_zooms;
+    bool edit_tool_selects_links;
+    bool edit_tool_also_seeks;
+    bool select_also_seeks;
+    bool paste_seeks;
+    QString img_seq_formats;
+	bool rectified_waveforms;
+	int default_transition_length;
+    int timecode_view;
+    bool show_title_safe_area;
+    bool use_custom_title_safe_ratio;
+    double custom_title_safe_ratio;
+	bool enable_drag_files_to_timeline;
+    bool autoscale_by_default;
+    bool scrub_audio;
+    int audio_buffer_ms;
+    int audio_notify_interval;
+    bool low_latency_audio;
+    int audio_latency_offset;
+    int ram_preview_memory; // megabytes
+    int playback_resolution;
+    bool software_rendering; // exports are drawn on the CPU instead of through OpenGL
+
+    void load(QString path);
+    void save(QString path);
+};
+
+extern Config config;
+
+#endif // CONFIG_H
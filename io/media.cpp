@@ -1,57 +1,63 @@
-#include "media.h"
-
-#include <QDebug>
-
-extern "C" {
-	#include <libavformat/avformat.h>
-}
-
-#include "project/clip.h"
-
-Media::Media() : ready(false) {}
-
-Media::~Media() {
-    reset();
-}
-
-void Media::reset() {
-    for (int i=0;i<video_tracks.size();i++) {
-        delete video_tracks.at(i);
-    }
-    for (int i=0;i<audio_tracks.size();i++) {
-        delete audio_tracks.at(i);
-    }
-    video_tracks.clear();
-    audio_tracks.clear();
-    ready = false;
-}
-
-long Media::get_length_in_frames(double frame_rate) {
-    return ceil(((double) length / (double) AV_TIME_BASE) * frame_rate);
-}
-
-MediaStream* Media::get_stream_from_file_index(bool video, int index) {
-    if (video) {
-        for (int i=0;i<video_tracks.size();i++) {
-            if (video_tracks.at(i)->file_index == index) {
-                return video_tracks.at(i);
-            }
-        }
-    } else {
-        for (int i=0;i<audio_tracks.size();i++) {
-            if (audio_tracks.at(i)->file_index == index) {
-                return audio_tracks.at(i);
-            }
-        }
-    }
-    return NULL;
-}
-
-int guess_layout_from_channels(int channel_count) {
-    if (channel_count == 1) {
-        return AV_CH_LAYOUT_MONO;
-    } else {
-        qDebug() << "[WARNING] Could not detect audio channel layout - assuming stereo";
-        return AV_CH_LAYOUT_STEREO;
-    }
-}
+#include "media.h"
+
+#include <QDebug>
+
+extern "C" {
+	#include <libavformat/avformat.h>
+}
+
+#include "project/clip.h"
+
+Media::Media() : ready(false) {}
+
+Media::~Media() {
+    reset();
+}
+
+void Media::reset() {
+    for (int i=0;i<video_tracks.size();i++) {
+        delete video_tracks.at(i);
+    }
+    for (int i=0;i<audio_tracks.size();i++) {
+        delete audio_tracks.at(i);
+    }
+    video_tracks.clear();
+    audio_tracks.clear();
+    ready = false;
+}
+
+long Media::get_length_in_frames(double frame_rate) {
+    return ceil(((double) length / (double) AV_TIME_BASE) * frame_rate);
+}
+
+MediaStream* Media::get_stream_from_file_index(bool video, int index) {
+    if (video) {
+        for (int i=0;i<video_tracks.size();i++) {
+            if (video_tracks.at(i)->file_index == index) {
+                return video_tracks.at(i);
+            }
+        }
+    } else {
+        for (int i=0;i<audio_tracks.size();i++) {
+            if (audio_tracks.at(i)->file_index == index) {
+                return audio_tracks.at(i);
+            }
+        }
+    }
+    return NULL;
+}
+
+int guess_layout_from_channels(int channel_count) {
+    switch (channel_count) {
+    case 1: return AV_CH_LAYOUT_MONO;
+    case 2: return AV_CH_LAYOUT_STEREO;
+    }
+
+    // use FFmpeg's default ordering for the channel count (e.g. 6 = 5.1, 8 = 7.1)
+    int layout = av_get_default_channel_layout(channel_count);
+    if (layout == 0) {
+        qDebug() << "[WARNING] Could not detect audio channel layout - assuming stereo";
+        return AV_CH_LAYOUT_STEREO;
+    }
+    return layout;
+}
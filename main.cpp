@@ -1,18 +1,22 @@
-#include "mainwindow.h"
-#include <QApplication>
-
-extern "C" {
-	#include <libavformat/avformat.h>
-}
-
-int main(int argc, char *argv[])
-{
-	// init ffmpeg subsystem
-	av_register_all();
-
-    QApplication a(argc, argv);
-	MainWindow w;
-	w.show();
-
-	return a.exec();
-}
+#include "mainwindow.h"
+#include <QApplication>
+#include <QDateTime>
+
+extern "C" {
+	#include <libavformat/avformat.h>
+}
+
+int main(int argc, char *argv[])
+{
+	// init ffmpeg subsystem
+	av_register_all();
+
+	// effects with a seed pick their first one with qrand(), which would give the same sequence every session
+	qsrand(static_cast<uint>(QDateTime::currentMSecsSinceEpoch() ^ QCoreApplication::applicationPid()));
+
+    QApplication a(argc, argv);
+	MainWindow w;
+	w.show();
+
+	return a.exec();
+}
@@ -1,14 +1,14 @@
-#ifndef PANELS_H
-#define PANELS_H
-
-class Project;
-class EffectControls;
-class Viewer;
-class Timeline;
-
-extern Project* panel_project;
-extern EffectControls* panel_effect_controls;
-extern Viewer* panel_viewer;
-extern Timeline* panel_timeline;
-
-#endif // PANELS_H
+#ifndef PANELS_H
+#define PANELS_H
+
+class Project;
+class EffectControls;
+class Viewer;
+class Timeline;
+
+extern Project* panel_project;
+extern EffectControls* panel_effect_controls;
+extern Viewer* panel_viewer;
+extern Timeline* panel_timeline;
+
+#endif // PANELS_H
@@ -1,168 +1,338 @@
-#include "audio.h"
-
-#include "project/sequence.h"
-
-#include "panels/panels.h"
-#include "panels/timeline.h"
-#include "ui_timeline.h"
-
-#include <QAudioOutput>
-#include <QtMath>
-#include <QDebug>
-
-extern "C" {
-	#include <libavcodec/avcodec.h>
-}
-
-QAudioOutput* audio_output;
-QIODevice* audio_io_device;
-bool audio_device_set = false;
-QMutex audio_write_lock;
-
-qint8 audio_ibuffer[audio_ibuffer_size];
-int audio_ibuffer_read = 0;
-long audio_ibuffer_frame = 0;
-double audio_ibuffer_timecode = 0;
-
-AudioSenderThread* audio_thread;
-
-void init_audio() {
-	stop_audio();
-
-    if (sequence != NULL) {
-		QAudioFormat audio_format;
-        audio_format.setSampleRate(sequence->audio_frequency);
-        audio_format.setChannelCount(av_get_channel_layout_nb_channels(sequence->audio_layout));
-		audio_format.setSampleSize(16);
-		audio_format.setCodec("audio/pcm");
-		audio_format.setByteOrder(QAudioFormat::LittleEndian);
-		audio_format.setSampleType(QAudioFormat::SignedInt);
-
-		QAudioDeviceInfo info(QAudioDeviceInfo::defaultOutputDevice());
-		if (!info.isFormatSupported(audio_format)) {
-			qWarning() << "[WARNING] Couldn't initialize audio. Audio format is not supported by backend";
-		} else {
-			audio_output = new QAudioOutput(audio_format);
-			audio_output->setNotifyInterval(5);
-
-			// connect
-			audio_io_device = audio_output->start();
-			audio_device_set = true;
-
-			// start sender thread
-			audio_thread = new AudioSenderThread();
-			QObject::connect(audio_output, SIGNAL(notify()), audio_thread, SLOT(notifyReceiver()));
-			audio_thread->start(QThread::TimeCriticalPriority);
-
-            clear_audio_ibuffer();
-		}
-	}
-}
-
-void stop_audio() {
-	if (audio_device_set) {
-		audio_thread->stop();
-
-		audio_output->stop();
-		delete audio_output;
-		audio_device_set = false;
-	}
-}
-
-void clear_audio_ibuffer() {
-	memset(audio_ibuffer, 0, audio_ibuffer_size);
-    audio_ibuffer_read = 0;
-}
-
-int get_buffer_offset_from_frame(long frame) {
-	// currently debugging this function. since it has a high potential of failure and isn't actually fatal, we only assert on debug mode
-#ifdef QT_DEBUG
-	Q_ASSERT(frame >= audio_ibuffer_frame);
-	return qFloor(av_samples_get_buffer_size(NULL, av_get_channel_layout_nb_channels(sequence->audio_layout), qRound(((frame-audio_ibuffer_frame)/sequence->frame_rate)*sequence->audio_frequency), AV_SAMPLE_FMT_S16, 1)/4)*4;
-#else
-	if (frame >= audio_ibuffer_frame) {
-		return qFloor(av_samples_get_buffer_size(NULL, av_get_channel_layout_nb_channels(sequence->audio_layout), qRound(((frame-audio_ibuffer_frame)/sequence->frame_rate)*sequence->audio_frequency), AV_SAMPLE_FMT_S16, 1)/4)*4;
-	} else {
-		qDebug() << "[WARNING] Invalid values passed to get_buffer_offset_from_frame";
-		return 0;
-	}
-#endif
-}
-
-AudioSenderThread::AudioSenderThread() : close(false) {
-	connect(this, SIGNAL(finished()), this, SLOT(deleteLater()));
-}
-
-void AudioSenderThread::stop() {
-	close = true;
-	cond.wakeAll();
-	wait();
-}
-
-void AudioSenderThread::notifyReceiver() {
-	cond.wakeAll();
-}
-
-void AudioSenderThread::run() {
-	// start data loop
-	send_audio_to_output(0, audio_ibuffer_size);
-
-	lock.lock();
-	while (true) {
-		cond.wait(&lock);
-		if (close) {
-			break;
-		} else if (panel_timeline->playing) {
-			int written_bytes = 0;
-
-			int adjusted_read_index = audio_ibuffer_read%audio_ibuffer_size;
-			int max_write = audio_ibuffer_size - adjusted_read_index;
-			int actual_write = send_audio_to_output(adjusted_read_index, max_write);
-			written_bytes += actual_write;
-			if (actual_write == max_write) {
-				// got all the bytes, write again
-				written_bytes += send_audio_to_output(0, audio_ibuffer_size);
-			}
-		}
-	}
-	lock.unlock();
-}
-
-int AudioSenderThread::send_audio_to_output(int offset, int max) {
-	// send audio to device
-	int actual_write = audio_io_device->write((const char*) audio_ibuffer+offset, max);
-
-	int audio_ibuffer_limit = audio_ibuffer_read + actual_write;
-
-	// send samples to audio monitor cache
-	if (panel_timeline->ui->audio_monitor->sample_cache_offset == -1) {
-		panel_timeline->ui->audio_monitor->sample_cache_offset = sequence->playhead;
-	}
-	int channel_count = av_get_channel_layout_nb_channels(sequence->audio_layout);
-	long sample_cache_playhead = panel_timeline->ui->audio_monitor->sample_cache_offset + (panel_timeline->ui->audio_monitor->sample_cache.size()/channel_count);
-	int next_buffer_offset, buffer_offset_adjusted, i;
-	int buffer_offset = get_buffer_offset_from_frame(sample_cache_playhead);
-	if (samples.size() != channel_count) samples.resize(channel_count);
-	samples.fill(0);
-
-	// TODO: I don't like this, but i'm not sure if there's a smarter way to do it
-	while (buffer_offset < audio_ibuffer_limit) {
-		sample_cache_playhead++;
-		next_buffer_offset = qMin(get_buffer_offset_from_frame(sample_cache_playhead), audio_ibuffer_limit);
-		while (buffer_offset < next_buffer_offset) {
-			for (i=0;i<samples.size();i++) {
-				buffer_offset_adjusted = buffer_offset%audio_ibuffer_size;
-				samples[i] = qMax(qAbs((qint16) (((audio_ibuffer[buffer_offset_adjusted+1] & 0xFF) << 8) | (audio_ibuffer[buffer_offset_adjusted] & 0xFF))), samples[i]);
-				buffer_offset += 2;
-			}
-		}
-		panel_timeline->ui->audio_monitor->sample_cache.append(samples);
-		buffer_offset = next_buffer_offset;
-	}
-
-	memset(audio_ibuffer+offset, 0, actual_write);
-
-	audio_ibuffer_read = audio_ibuffer_limit;
-
-	return actual_write;
-}
+#include "audio.h"
+
+#include "project/sequence.h"
+#include "playback/audiometer.h"
+#include "playback/scrub.h"
+#include "io/config.h"
+
+#include "panels/panels.h"
+#include "panels/timeline.h"
+#include "ui_timeline.h"
+
+#include <QAudioOutput>
+#include <QAtomicInt>
+#include <QtMath>
+#include <QDebug>
+
+extern "C" {
+	#include <libavcodec/avcodec.h>
+	#include <libswresample/swresample.h>
+}
+
+// device buffer and notify interval used in low latency mode, in milliseconds
+#define AUDIO_LOW_LATENCY_BUFFER 30
+#define AUDIO_LOW_LATENCY_NOTIFY 2
+
+#define CHANNEL_MASK_LEFT (AV_CH_FRONT_LEFT | AV_CH_BACK_LEFT | AV_CH_SIDE_LEFT | AV_CH_FRONT_LEFT_OF_CENTER | AV_CH_TOP_FRONT_LEFT | AV_CH_TOP_BACK_LEFT | AV_CH_STEREO_LEFT | AV_CH_WIDE_LEFT | AV_CH_SURROUND_DIRECT_LEFT)
+#define CHANNEL_MASK_RIGHT (AV_CH_FRONT_RIGHT | AV_CH_BACK_RIGHT | AV_CH_SIDE_RIGHT | AV_CH_FRONT_RIGHT_OF_CENTER | AV_CH_TOP_FRONT_RIGHT | AV_CH_TOP_BACK_RIGHT | AV_CH_STEREO_RIGHT | AV_CH_WIDE_RIGHT | AV_CH_SURROUND_DIRECT_RIGHT)
+
+QAudioOutput* audio_output;
+QIODevice* audio_io_device;
+bool audio_device_set = false;
+QMutex audio_write_lock;
+QAudioFormat audio_output_format;
+
+// microseconds of audio queued in the device, measured by the sender thread every time it writes
+QAtomicInt audio_output_latency;
+
+alignas(16) qint8 audio_ibuffer[audio_ibuffer_size];
+int audio_ibuffer_read = 0;
+long audio_ibuffer_frame = 0;
+double audio_ibuffer_timecode = 0;
+
+AudioSenderThread* audio_thread;
+
+// channel count actually sent to the output device, differs from the sequence's if we're downmixing
+int audio_output_channels = 0;
+
+// (output channels x sequence channels) gain matrix, empty if the device takes the sequence layout as-is
+QVector<float> audio_downmix_matrix;
+QVector<qint16> audio_downmix_buffer;
+
+QMutex audio_scrub_lock;
+QVector<qint16> audio_scrub_grain;
+int audio_scrub_read = 0;
+
+void init_audio() {
+	stop_audio();
+
+    if (sequence != NULL) {
+		QAudioFormat audio_format;
+        audio_format.setSampleRate(sequence->audio_frequency);
+        audio_format.setChannelCount(av_get_channel_layout_nb_channels(sequence->audio_layout));
+		audio_format.setSampleSize(16);
+		audio_format.setCodec("audio/pcm");
+		audio_format.setByteOrder(QAudioFormat::LittleEndian);
+		audio_format.setSampleType(QAudioFormat::SignedInt);
+
+		audio_output_channels = audio_format.channelCount();
+		audio_downmix_matrix.clear();
+
+		QAudioDeviceInfo info(QAudioDeviceInfo::defaultOutputDevice());
+		if (!info.isFormatSupported(audio_format) && audio_format.channelCount() > 2) {
+			// most output devices are stereo, so fold surround sequences down rather than going silent
+			audio_format.setChannelCount(2);
+			if (info.isFormatSupported(audio_format) && build_downmix_matrix(sequence->audio_layout, AV_CH_LAYOUT_STEREO, audio_downmix_matrix)) {
+				qDebug() << "[INFO] Output device doesn't support" << av_get_channel_layout_nb_channels(sequence->audio_layout) << "channels - downmixing to stereo";
+				audio_output_channels = 2;
+			}
+		}
+
+		if (!info.isFormatSupported(audio_format)) {
+			qWarning() << "[WARNING] Couldn't initialize audio. Audio format is not supported by backend";
+		} else {
+			audio_output = new QAudioOutput(audio_format);
+			audio_output_format = audio_format;
+
+			// a small device buffer makes starting and stopping responsive, a large one is safer against underruns
+			int buffer_ms = (config.low_latency_audio) ? AUDIO_LOW_LATENCY_BUFFER : config.audio_buffer_ms;
+			if (buffer_ms > 0) audio_output->setBufferSize(audio_format.bytesForDuration(buffer_ms * 1000));
+			audio_output->setNotifyInterval((config.low_latency_audio) ? AUDIO_LOW_LATENCY_NOTIFY : qMax(1, config.audio_notify_interval));
+
+			// connect
+			audio_io_device = audio_output->start();
+			audio_device_set = true;
+
+			// the backend may not honor the size we asked for, so start from what it actually gave us
+			audio_output_latency.store(audio_format.durationForBytes(audio_output->bufferSize()));
+			qDebug() << "[INFO] Audio output buffer is" << audio_format.durationForBytes(audio_output->bufferSize()) / 1000 << "ms";
+
+			// start sender thread
+			audio_thread = new AudioSenderThread();
+			QObject::connect(audio_output, SIGNAL(notify()), audio_thread, SLOT(notifyReceiver()));
+			audio_thread->start(QThread::TimeCriticalPriority);
+
+			// decodes scrub grains separately from the clips' cachers
+			scrub_thread = new ScrubThread(sequence->audio_layout, sequence->audio_frequency);
+			scrub_thread->start(QThread::HighPriority);
+
+            clear_audio_ibuffer();
+		}
+	}
+}
+
+void stop_audio() {
+	if (audio_device_set) {
+		scrub_thread->stop();
+		scrub_thread = NULL;
+
+		audio_thread->stop();
+
+		audio_output->stop();
+		delete audio_output;
+		audio_device_set = false;
+	}
+}
+
+int get_audio_latency() {
+	int latency = config.audio_latency_offset;
+	if (audio_device_set) latency += audio_output_latency.load() / 1000;
+	return latency;
+}
+
+void update_audio_latency() {
+	// everything written but not yet processed is still ahead of the speakers
+	int queued = audio_output->bufferSize() - audio_output->bytesFree();
+	int measured = audio_output_format.durationForBytes(qMax(0, queued));
+
+	// smooth it out, a jittery clock would make the video stutter
+	int latency = audio_output_latency.load();
+	audio_output_latency.store(latency + (measured - latency) / 8);
+}
+
+void clear_audio_ibuffer() {
+	memset(audio_ibuffer, 0, audio_ibuffer_size);
+    audio_ibuffer_read = 0;
+	audio_meter.reset(audio_ibuffer_frame);
+}
+
+int get_buffer_offset_from_frame(long frame) {
+	// currently debugging this function. since it has a high potential of failure and isn't actually fatal, we only assert on debug mode
+#ifdef QT_DEBUG
+	Q_ASSERT(frame >= audio_ibuffer_frame);
+	int channel_count = av_get_channel_layout_nb_channels(sequence->audio_layout);
+	return av_samples_get_buffer_size(NULL, channel_count, qRound(((frame-audio_ibuffer_frame)/sequence->frame_rate)*sequence->audio_frequency), AV_SAMPLE_FMT_S16, 1);
+#else
+	if (frame >= audio_ibuffer_frame) {
+		int channel_count = av_get_channel_layout_nb_channels(sequence->audio_layout);
+		return av_samples_get_buffer_size(NULL, channel_count, qRound(((frame-audio_ibuffer_frame)/sequence->frame_rate)*sequence->audio_frequency), AV_SAMPLE_FMT_S16, 1);
+	} else {
+		qDebug() << "[WARNING] Invalid values passed to get_buffer_offset_from_frame";
+		return 0;
+	}
+#endif
+}
+
+int get_channel_side(quint64 layout, int index) {
+	quint64 channel = av_channel_layout_extract_channel(layout, index);
+	if (channel & CHANNEL_MASK_LEFT) return -1;
+	if (channel & CHANNEL_MASK_RIGHT) return 1;
+	return 0;
+}
+
+void get_pan_gains(quint64 layout, double pan, float* gains) {
+	// pan ranges from -1.0 (left) to 1.0 (right) and attenuates the channels on the opposite side,
+	// center and LFE channels are left alone
+	int channel_count = av_get_channel_layout_nb_channels(layout);
+	for (int i=0;i<channel_count;i++) {
+		int side = get_channel_side(layout, i);
+		if (pan < 0 && side > 0) {
+			gains[i] = 1.0 + pan;
+		} else if (pan > 0 && side < 0) {
+			gains[i] = 1.0 - pan;
+		} else {
+			gains[i] = 1.0;
+		}
+	}
+}
+
+void apply_channel_gains(qint16* samples, int nb_frames, int channels, const float* gains) {
+	for (int i=0;i<nb_frames;i++) {
+		qint16* frame = samples + i*channels;
+		for (int j=0;j<channels;j++) {
+			frame[j] = static_cast<qint16>(qBound(static_cast<float>(INT16_MIN), frame[j]*gains[j], static_cast<float>(INT16_MAX)));
+		}
+	}
+}
+
+bool build_downmix_matrix(quint64 in_layout, quint64 out_layout, QVector<float>& matrix) {
+	int in_channels = av_get_channel_layout_nb_channels(in_layout);
+	int out_channels = av_get_channel_layout_nb_channels(out_layout);
+
+	// use swresample's own coefficients so preview downmixes the same way export does
+	QVector<double> coefficients(in_channels*out_channels);
+	int ret = swr_build_matrix(in_layout, out_layout, M_SQRT1_2, M_SQRT1_2, 0, 1, 0, coefficients.data(), in_channels, AV_MATRIX_ENCODING_NONE, NULL);
+	if (ret < 0) {
+		qDebug() << "[ERROR] Failed to build downmix matrix." << ret;
+		return false;
+	}
+
+	matrix.resize(coefficients.size());
+	for (int i=0;i<coefficients.size();i++) {
+		matrix[i] = coefficients.at(i);
+	}
+	return true;
+}
+
+void apply_channel_matrix(const qint16* in, int in_channels, qint16* out, int out_channels, int nb_frames, const float* matrix) {
+	for (int i=0;i<nb_frames;i++) {
+		const qint16* in_frame = in + i*in_channels;
+		qint16* out_frame = out + i*out_channels;
+		for (int j=0;j<out_channels;j++) {
+			const float* row = matrix + j*in_channels;
+			float sum = 0;
+			for (int k=0;k<in_channels;k++) {
+				sum += row[k]*in_frame[k];
+			}
+			out_frame[j] = static_cast<qint16>(qBound(static_cast<float>(INT16_MIN), sum, static_cast<float>(INT16_MAX)));
+		}
+	}
+}
+
+AudioSenderThread::AudioSenderThread() : close(false) {
+	connect(this, SIGNAL(finished()), this, SLOT(deleteLater()));
+}
+
+void AudioSenderThread::stop() {
+	close = true;
+	cond.wakeAll();
+	wait();
+}
+
+void AudioSenderThread::notifyReceiver() {
+	cond.wakeAll();
+}
+
+void AudioSenderThread::run() {
+	// start data loop
+	send_audio_to_output(0, audio_ibuffer_size);
+
+	lock.lock();
+	while (true) {
+		cond.wait(&lock);
+		if (close) {
+			break;
+		} else if (panel_timeline->playing) {
+			// playback takes over from scrubbing
+			audio_scrub_lock.lock();
+			audio_scrub_read = audio_scrub_grain.size();
+			audio_scrub_lock.unlock();
+
+			int written_bytes = 0;
+
+			int adjusted_read_index = audio_ibuffer_read%audio_ibuffer_size;
+			int max_write = audio_ibuffer_size - adjusted_read_index;
+			int actual_write = send_audio_to_output(adjusted_read_index, max_write);
+			written_bytes += actual_write;
+			if (actual_write == max_write) {
+				// got all the bytes, write again
+				written_bytes += send_audio_to_output(0, audio_ibuffer_size);
+			}
+		} else {
+			send_scrub_to_output();
+		}
+	}
+	lock.unlock();
+}
+
+void AudioSenderThread::send_scrub_to_output() {
+	audio_scrub_lock.lock();
+	int in_channels = av_get_channel_layout_nb_channels(sequence->audio_layout);
+	int out_frame_size = audio_output_channels << 1;
+
+	// only write what the device can take right now, so a newer grain never queues up behind this one
+	int nb_frames = qMin((audio_scrub_grain.size() - audio_scrub_read) / in_channels, audio_output->bytesFree() / out_frame_size);
+	if (nb_frames > 0) {
+		const qint16* in = audio_scrub_grain.constData() + audio_scrub_read;
+		int out_write;
+		if (audio_downmix_matrix.isEmpty()) {
+			out_write = audio_io_device->write((const char*) in, nb_frames*out_frame_size);
+		} else {
+			if (audio_downmix_buffer.size() < nb_frames*audio_output_channels) audio_downmix_buffer.resize(nb_frames*audio_output_channels);
+			apply_channel_matrix(in, in_channels, audio_downmix_buffer.data(), audio_output_channels, nb_frames, audio_downmix_matrix.constData());
+			out_write = audio_io_device->write((const char*) audio_downmix_buffer.constData(), nb_frames*out_frame_size);
+		}
+		audio_scrub_read += qMax(0, out_write / out_frame_size) * in_channels;
+	}
+	audio_scrub_lock.unlock();
+}
+
+void queue_scrub_grain(const QVector<qint16>& grain) {
+	audio_scrub_lock.lock();
+	audio_scrub_grain = grain;
+	audio_scrub_read = 0;
+	audio_scrub_lock.unlock();
+
+	// the device goes idle between grains and stops notifying, so wake the sender ourselves
+	if (audio_thread != NULL) audio_thread->notifyReceiver();
+}
+
+int AudioSenderThread::send_audio_to_output(int offset, int max) {
+	// send audio to device
+	int actual_write;
+	if (audio_downmix_matrix.isEmpty()) {
+		actual_write = audio_io_device->write((const char*) audio_ibuffer+offset, max);
+	} else {
+		int in_channels = av_get_channel_layout_nb_channels(sequence->audio_layout);
+		int in_frame_size = in_channels << 1;
+		int out_frame_size = audio_output_channels << 1;
+		int nb_frames = qMin(max / in_frame_size, audio_output->bytesFree() / out_frame_size);
+		if (audio_downmix_buffer.size() < nb_frames*audio_output_channels) audio_downmix_buffer.resize(nb_frames*audio_output_channels);
+		apply_channel_matrix(reinterpret_cast<const qint16*>(audio_ibuffer+offset), in_channels, audio_downmix_buffer.data(), audio_output_channels, nb_frames, audio_downmix_matrix.constData());
+		int out_write = audio_io_device->write((const char*) audio_downmix_buffer.constData(), nb_frames*out_frame_size);
+		actual_write = (out_write / out_frame_size) * in_frame_size;
+	}
+
+	int audio_ibuffer_limit = audio_ibuffer_read + actual_write;
+
+	// meter what we just sent before it's cleared
+	audio_meter.process(audio_ibuffer_limit);
+
+	memset(audio_ibuffer+offset, 0, actual_write);
+
+	audio_ibuffer_read = audio_ibuffer_limit;
+
+	update_audio_latency();
+
+	return actual_write;
+}
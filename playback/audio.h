@@ -1,49 +1,68 @@
-#ifndef AUDIO_H
-#define AUDIO_H
-
-#include <QVector>
-#include <QThread>
-#include <QWaitCondition>
-#include <QMutex>
-
-//#define INT16_MAX 0x7fff
-//#define INT16_MIN (-INT16_MAX-1)
-
-class QIODevice;
-class QAudioOutput;
-
-struct Sequence;
-
-class AudioSenderThread : public QThread {
-	Q_OBJECT
-public:
-	AudioSenderThread();
-	void run();
-	void stop();
-	QWaitCondition cond;
-	bool close;
-	QMutex lock;
-public slots:
-	void notifyReceiver();
-private:
-	QVector<qint16> samples;
-	int send_audio_to_output(int offset, int max);
-};
-
-extern QAudioOutput* audio_output;
-extern QIODevice* audio_io_device;
-extern AudioSenderThread* audio_thread;
-extern QMutex audio_write_lock;
-
-#define audio_ibuffer_size 192000
-extern qint8 audio_ibuffer[audio_ibuffer_size];
-extern int audio_ibuffer_read;
-extern long audio_ibuffer_frame;
-extern double audio_ibuffer_timecode;
-void clear_audio_ibuffer();
-
-void init_audio();
-void stop_audio();
-int get_buffer_offset_from_frame(long frame);
-
-#endif // AUDIO_H
+#ifndef AUDIO_H
+#define AUDIO_H
+
+#include <QVector>
+#include <QThread>
+#include <QWaitCondition>
+#include <QMutex>
+
+#include "playback/audiokernels.h"
+
+//#define INT16_MAX 0x7fff
+//#define INT16_MIN (-INT16_MAX-1)
+
+class QIODevice;
+class QAudioOutput;
+
+struct Sequence;
+
+class AudioSenderThread : public QThread {
+	Q_OBJECT
+public:
+	AudioSenderThread();
+	void run();
+	void stop();
+	QWaitCondition cond;
+	bool close;
+	QMutex lock;
+public slots:
+	void notifyReceiver();
+private:
+	int send_audio_to_output(int offset, int max);
+	void send_scrub_to_output();
+};
+
+extern QAudioOutput* audio_output;
+extern QIODevice* audio_io_device;
+extern AudioSenderThread* audio_thread;
+extern QMutex audio_write_lock;
+
+// divisible by the frame size (channels * 2 bytes) of mono, stereo, 5.1 and 7.1
+// so the ring buffer always wraps on a sample frame boundary
+#define audio_ibuffer_size 192000
+extern qint8 audio_ibuffer[audio_ibuffer_size];
+extern int audio_ibuffer_read;
+extern long audio_ibuffer_frame;
+extern double audio_ibuffer_timecode;
+void clear_audio_ibuffer();
+
+extern int audio_output_channels;
+
+void init_audio();
+void stop_audio();
+
+// time between audio being sent to the device and it being heard, in milliseconds - includes the user's offset
+int get_audio_latency();
+int get_buffer_offset_from_frame(long frame);
+
+// scrub voice - replaces whatever is left of the previous grain, only heard while the timeline isn't playing
+void queue_scrub_grain(const QVector<qint16>& grain);
+
+// channel layout helpers - gains are laid out per channel in the order FFmpeg interleaves them
+int get_channel_side(quint64 layout, int index);
+void get_pan_gains(quint64 layout, double pan, float* gains);
+void apply_channel_gains(qint16* samples, int nb_frames, int channels, const float* gains);
+bool build_downmix_matrix(quint64 in_layout, quint64 out_layout, QVector<float>& matrix);
+void apply_channel_matrix(const qint16* in, int in_channels, qint16* out, int out_channels, int nb_frames, const float* matrix);
+
+#endif // AUDIO_H
@@ -0,0 +1,78 @@
+#include "audiokernels.h"
+
+#include <QtMath>
+#include <cstdint>
+
+int get_block_frames(int channels) {
+	return qBound(1, AUDIO_KERNEL_BUFFER / qMax(1, channels), AUDIO_KERNEL_BLOCK);
+}
+
+void samples_to_float(const qint16* in, float* out, int count) {
+	for (int i=0;i<count;i++) {
+		out[i] = in[i];
+	}
+}
+
+void float_to_samples(const float* in, qint16* out, int count) {
+	for (int i=0;i<count;i++) {
+		out[i] = static_cast<qint16>(qBound(static_cast<float>(INT16_MIN), in[i], static_cast<float>(INT16_MAX)));
+	}
+}
+
+void apply_gain_ramp(float* samples, int nb_frames, int channels, float gain_start, float gain_end) {
+	if (gain_start == gain_end) {
+		// constant gain is by far the most common case, keep it a flat loop
+		int count = nb_frames*channels;
+		for (int i=0;i<count;i++) {
+			samples[i] *= gain_start;
+		}
+	} else {
+		float step = (gain_end - gain_start) / nb_frames;
+		for (int i=0;i<nb_frames;i++) {
+			float gain = gain_start + step*i;
+			float* frame = samples + i*channels;
+			for (int j=0;j<channels;j++) {
+				frame[j] *= gain;
+			}
+		}
+	}
+}
+
+void mix_mono_block(float* samples, int nb_frames, int channels, const float* mono, bool replace) {
+	for (int i=0;i<nb_frames;i++) {
+		float* frame = samples + i*channels;
+		for (int j=0;j<channels;j++) {
+			frame[j] = (replace) ? mono[i] : frame[j] + mono[i];
+		}
+	}
+}
+
+double sine_block(float* out, int nb_frames, double phase, double increment) {
+	double w = 2*M_PI*increment;
+	double cos_w = qCos(w);
+	double sin_w = qSin(w);
+	double re = qCos(2*M_PI*phase);
+	double im = qSin(2*M_PI*phase);
+	for (int i=0;i<nb_frames;i++) {
+		out[i] = im;
+		double next_re = re*cos_w - im*sin_w;
+		im = re*sin_w + im*cos_w;
+		re = next_re;
+	}
+	phase += increment*nb_frames;
+	return phase - qFloor(phase);
+}
+
+void gain_samples_block(qint16* samples, int nb_frames, int channels, float gain_start, float gain_end) {
+	float block[AUDIO_KERNEL_BUFFER];
+	samples_to_float(samples, block, nb_frames*channels);
+	apply_gain_ramp(block, nb_frames, channels, gain_start, gain_end);
+	float_to_samples(block, samples, nb_frames*channels);
+}
+
+void mix_mono_samples_block(qint16* samples, int nb_frames, int channels, const float* mono, bool replace) {
+	float block[AUDIO_KERNEL_BUFFER];
+	samples_to_float(samples, block, nb_frames*channels);
+	mix_mono_block(block, nb_frames, channels, mono, replace);
+	float_to_samples(block, samples, nb_frames*channels);
+}
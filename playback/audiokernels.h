@@ -0,0 +1,35 @@
+#ifndef AUDIOKERNELS_H
+#define AUDIOKERNELS_H
+
+#include <QtGlobal>
+
+// audio effects work on float blocks of this many sample frames (in 16-bit units, not normalized),
+// keyframed values only need evaluating at block boundaries and gains are ramped in between.
+// kept apart from audio.cpp so benchmarks/audiokernels can build them without the rest of the program
+#define AUDIO_KERNEL_BLOCK 64
+#define AUDIO_MAX_CHANNELS 8 // 7.1
+
+// floats in an interleaved block buffer. layouts with more than AUDIO_MAX_CHANNELS get fewer sample frames per block
+// so they still fit, there are at most 64 as a layout is a 64-bit channel mask
+#define AUDIO_KERNEL_BUFFER (AUDIO_KERNEL_BLOCK*AUDIO_MAX_CHANNELS)
+#define AUDIO_LAYOUT_MAX_CHANNELS 64
+
+// sample frames of channels interleaved channels per block, so a block always fits in AUDIO_KERNEL_BUFFER
+int get_block_frames(int channels);
+
+void samples_to_float(const qint16* in, float* out, int count);
+void float_to_samples(const float* in, qint16* out, int count);
+void apply_gain_ramp(float* samples, int nb_frames, int channels, float gain_start, float gain_end);
+void mix_mono_block(float* samples, int nb_frames, int channels, const float* mono, bool replace);
+
+// nb_frames of a unit sine from phase (0.0 - 1.0 of a cycle) on, increment cycles apart, returning the phase the
+// next block starts at. rotates a phasor rather than calling sin per sample, it's re-seeded from the wrapped phase
+// every block so rounding error can't build up
+double sine_block(float* out, int nb_frames, double phase, double increment);
+
+// what VolumeEffect and ToneEffect do to each block of their interleaved 16-bit samples, in place. nb_frames is at
+// most get_block_frames(channels)
+void gain_samples_block(qint16* samples, int nb_frames, int channels, float gain_start, float gain_end);
+void mix_mono_samples_block(qint16* samples, int nb_frames, int channels, const float* mono, bool replace);
+
+#endif // AUDIOKERNELS_H
@@ -0,0 +1,213 @@
+#include "audiometer.h"
+
+#include "project/sequence.h"
+#include "playback/audio.h"
+
+#include <QtMath>
+#include <QDebug>
+
+extern "C" {
+	#include <libavcodec/avcodec.h>
+}
+
+// blocks the GUI looks back through - far fewer than the ring holds, so the sender can't lap the reader mid-copy
+#define AUDIO_METER_LOOKBACK 64
+
+AudioMeter audio_meter;
+
+AudioMeter::AudioMeter() :
+	write_index(0),
+	generation(0),
+	reset_requested(0),
+	reset_frame(0),
+	channels(0),
+	block_generation(0),
+	current_frame(0),
+	offset(0),
+	frame_end_offset(0)
+{
+	for (int i=0;i<AUDIO_METER_RING_SIZE;i++) {
+		ring[i].generation = -1;
+	}
+}
+
+void AudioMeter::reset(long frame) {
+	reset_frame = frame;
+	generation.fetchAndAddOrdered(1);
+	reset_requested.storeRelease(1);
+}
+
+void AudioMeter::apply_reset() {
+	block_generation = generation.loadAcquire();
+	current_frame = reset_frame;
+	offset = 0;
+	channels = 0;
+
+	if (sequence == NULL) return;
+
+	channels = qMin(av_get_channel_layout_nb_channels(sequence->audio_layout), AUDIO_METER_MAX_CHANNELS);
+	frame_end_offset = get_buffer_offset_from_frame(current_frame + 1);
+
+	setup_filter(sequence->audio_frequency);
+
+	// BS.1770 channel weights - surrounds count slightly more, LFE isn't counted at all
+	for (int i=0;i<channels;i++) {
+		quint64 channel = av_channel_layout_extract_channel(sequence->audio_layout, i);
+		if (channel & (AV_CH_LOW_FREQUENCY | AV_CH_LOW_FREQUENCY_2)) {
+			channel_weight[i] = 0.0f;
+		} else if (channel & (AV_CH_BACK_LEFT | AV_CH_BACK_RIGHT | AV_CH_SIDE_LEFT | AV_CH_SIDE_RIGHT)) {
+			channel_weight[i] = 1.41f;
+		} else {
+			channel_weight[i] = 1.0f;
+		}
+	}
+
+	memset(filter_state, 0, sizeof(filter_state));
+	memset(block_peak, 0, sizeof(block_peak));
+	memset(block_square, 0, sizeof(block_square));
+	block_energy = 0;
+	block_samples = 0;
+
+	window_start = 0;
+	window_count = 0;
+	window_energy_sum = 0;
+	window_sample_sum = 0;
+	window_length = qRound(sequence->audio_frequency * 0.4);
+}
+
+void AudioMeter::setup_filter(int sample_rate) {
+	// K-weighting coefficients derived for any sample rate (identical to the BS.1770 table at 48kHz)
+	double f0 = 1681.974450955533;
+	double G = 3.999843853973347;
+	double Q = 0.7071752369554196;
+	double K = qTan(M_PI * f0 / sample_rate);
+	double Vh = qPow(10.0, G / 20.0);
+	double Vb = qPow(Vh, 0.4996667741545416);
+	double a0 = 1.0 + K / Q + K * K;
+
+	filter_b[0][0] = (Vh + Vb * K / Q + K * K) / a0;
+	filter_b[0][1] = 2.0 * (K * K - Vh) / a0;
+	filter_b[0][2] = (Vh - Vb * K / Q + K * K) / a0;
+	filter_a[0][0] = 1.0;
+	filter_a[0][1] = 2.0 * (K * K - 1.0) / a0;
+	filter_a[0][2] = (1.0 - K / Q + K * K) / a0;
+
+	f0 = 38.13547087602444;
+	Q = 0.5003270373238773;
+	K = qTan(M_PI * f0 / sample_rate);
+	a0 = 1.0 + K / Q + K * K;
+
+	filter_b[1][0] = 1.0;
+	filter_b[1][1] = -2.0;
+	filter_b[1][2] = 1.0;
+	filter_a[1][0] = 1.0;
+	filter_a[1][1] = 2.0 * (K * K - 1.0) / a0;
+	filter_a[1][2] = (1.0 - K / Q + K * K) / a0;
+}
+
+void AudioMeter::accumulate(const qint16* samples, int nb_frames) {
+	for (int i=0;i<nb_frames;i++) {
+		const qint16* frame = samples + i*channels;
+		for (int j=0;j<channels;j++) {
+			double x = frame[j] / 32768.0;
+
+			block_peak[j] = qMax(block_peak[j], static_cast<float>(qAbs(x)));
+			block_square[j] += x*x;
+
+			// two transposed direct form II biquads
+			double (*z)[2] = filter_state[j];
+			for (int k=0;k<2;k++) {
+				double y = filter_b[k][0] * x + z[k][0];
+				z[k][0] = filter_b[k][1] * x - filter_a[k][1] * y + z[k][1];
+				z[k][1] = filter_b[k][2] * x - filter_a[k][2] * y;
+				x = y;
+			}
+			block_energy += channel_weight[j] * x * x;
+		}
+	}
+	block_samples += nb_frames;
+}
+
+void AudioMeter::finish_block() {
+	// slide the momentary window forward, dropping blocks that are no longer needed to cover 400ms
+	if (window_count == AUDIO_METER_WINDOW_BLOCKS) {
+		window_energy_sum -= window_energy[window_start];
+		window_sample_sum -= window_samples[window_start];
+		window_start = (window_start + 1) % AUDIO_METER_WINDOW_BLOCKS;
+		window_count--;
+	}
+	int slot = (window_start + window_count) % AUDIO_METER_WINDOW_BLOCKS;
+	window_energy[slot] = block_energy;
+	window_samples[slot] = block_samples;
+	window_energy_sum += block_energy;
+	window_sample_sum += block_samples;
+	window_count++;
+	while (window_count > 1 && window_sample_sum - window_samples[window_start] >= window_length) {
+		window_energy_sum -= window_energy[window_start];
+		window_sample_sum -= window_samples[window_start];
+		window_start = (window_start + 1) % AUDIO_METER_WINDOW_BLOCKS;
+		window_count--;
+	}
+
+	int index = write_index.loadAcquire();
+	AudioMeterBlock& block = ring[index % AUDIO_METER_RING_SIZE];
+	block.frame = current_frame;
+	block.generation = block_generation;
+	block.channels = channels;
+	for (int i=0;i<channels;i++) {
+		block.peak[i] = block_peak[i];
+		block.rms[i] = (block_samples > 0) ? qSqrt(block_square[i] / block_samples) : 0;
+	}
+	if (window_sample_sum > 0 && window_energy_sum > 0) {
+		block.momentary_loudness = qMax(AUDIO_METER_MIN_LOUDNESS, static_cast<float>(-0.691 + 10.0 * log10(window_energy_sum / window_sample_sum)));
+	} else {
+		block.momentary_loudness = AUDIO_METER_MIN_LOUDNESS;
+	}
+	write_index.storeRelease(index + 1);
+
+	memset(block_peak, 0, sizeof(block_peak));
+	memset(block_square, 0, sizeof(block_square));
+	block_energy = 0;
+	block_samples = 0;
+}
+
+void AudioMeter::process(int end) {
+	if (reset_requested.testAndSetAcquire(1, 0)) apply_reset();
+	if (channels == 0) return;
+
+	// only whole sample frames are metered, a partial one is picked up on the next call
+	int frame_size = channels << 1;
+	end -= (end - offset) % frame_size;
+
+	while (offset < end) {
+		int block_end = qMin(frame_end_offset, end);
+
+		// the ring buffer may wrap inside this block
+		while (offset < block_end) {
+			int index = offset % audio_ibuffer_size;
+			int length = qMin(block_end - offset, audio_ibuffer_size - index);
+			accumulate(reinterpret_cast<const qint16*>(audio_ibuffer + index), length / frame_size);
+			offset += length;
+		}
+
+		if (offset >= frame_end_offset) {
+			finish_block();
+			current_frame++;
+			frame_end_offset = get_buffer_offset_from_frame(current_frame + 1);
+		}
+	}
+}
+
+bool AudioMeter::get_block(long frame, AudioMeterBlock& block) {
+	int current_generation = generation.loadAcquire();
+	int index = write_index.loadAcquire();
+	int limit = qMax(0, index - AUDIO_METER_LOOKBACK);
+	for (int i=index-1;i>=limit;i--) {
+		const AudioMeterBlock& b = ring[i % AUDIO_METER_RING_SIZE];
+		if (b.generation == current_generation && b.frame == frame) {
+			block = b;
+			return true;
+		}
+	}
+	return false;
+}
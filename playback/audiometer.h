@@ -0,0 +1,76 @@
+#ifndef AUDIOMETER_H
+#define AUDIOMETER_H
+
+#include <QAtomicInt>
+
+#define AUDIO_METER_MAX_CHANNELS 8 // 7.1
+#define AUDIO_METER_RING_SIZE 512
+#define AUDIO_METER_WINDOW_BLOCKS 128
+#define AUDIO_METER_MIN_LOUDNESS -70.0f
+
+// levels of one sequence frame's worth of audio
+struct AudioMeterBlock {
+	long frame;
+	int generation;
+	int channels;
+	float peak[AUDIO_METER_MAX_CHANNELS]; // 0.0 - 1.0 of full scale
+	float rms[AUDIO_METER_MAX_CHANNELS]; // 0.0 - 1.0 of full scale
+	float momentary_loudness; // EBU R128 momentary loudness (400ms window) in LUFS
+};
+
+class AudioMeter {
+public:
+	AudioMeter();
+
+	// may be called from any thread, the sender thread applies it before metering anything else
+	void reset(long frame);
+
+	// sender thread only - meters audio_ibuffer up to the given absolute byte offset
+	void process(int end);
+
+	// GUI thread - copies the block for this frame if it has been metered, never blocks the sender
+	bool get_block(long frame, AudioMeterBlock& block);
+private:
+	void apply_reset();
+	void setup_filter(int sample_rate);
+	void accumulate(const qint16* samples, int nb_frames);
+	void finish_block();
+
+	// published blocks, single producer/single consumer
+	AudioMeterBlock ring[AUDIO_METER_RING_SIZE];
+	QAtomicInt write_index;
+	QAtomicInt generation;
+	QAtomicInt reset_requested;
+	long reset_frame;
+
+	// everything below is only touched by the sender thread
+	int channels;
+	int block_generation;
+	long current_frame;
+	int offset;
+	int frame_end_offset;
+
+	float block_peak[AUDIO_METER_MAX_CHANNELS];
+	double block_square[AUDIO_METER_MAX_CHANNELS];
+	double block_energy; // K-weighted and channel-weighted sum of squares
+	int block_samples;
+
+	// K-weighting (pre-filter shelf + RLB high-pass) as two biquads
+	double filter_b[2][3];
+	double filter_a[2][3];
+	double filter_state[AUDIO_METER_MAX_CHANNELS][2][2];
+	float channel_weight[AUDIO_METER_MAX_CHANNELS];
+
+	// sliding window over the most recent blocks for momentary loudness
+	double window_energy[AUDIO_METER_WINDOW_BLOCKS];
+	int window_samples[AUDIO_METER_WINDOW_BLOCKS];
+	int window_start;
+	int window_count;
+	double window_energy_sum;
+	int window_sample_sum;
+	int window_length;
+};
+
+extern AudioMeter audio_meter;
+
+#endif // AUDIOMETER_H
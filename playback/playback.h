@@ -1,40 +1,56 @@
-#ifndef PLAYBACK_H
-#define PLAYBACK_H
-
-#include <QVector>
-#include <QMutex>
-
-struct Clip;
-struct ClipCache;
-struct Sequence;
-struct AVFrame;
-
-extern bool texture_failed;
-
-void open_clip(Clip* clip, bool multithreaded);
-void cache_clip(Clip* clip, long playhead, bool write_A, bool write_B, bool reset, Clip *nest);
-void close_clip(Clip* clip);
-void cache_audio_worker(Clip* c, bool write_A);
-void cache_video_worker(Clip* c, long playhead, ClipCache* cache);
-void handle_media(Sequence* sequence, long playhead, bool multithreaded);
-void reset_cache(Clip* c, long target_frame);
-bool get_clip_frame(Clip* c, long playhead);
-double playhead_to_seconds(Clip* c, long playhead);
-long seconds_to_clip_frame(Clip* c, double seconds);
-double clip_frame_to_seconds(Clip* c, long clip_frame);
-int retrieve_next_frame(Clip* c, AVFrame* f);
-void retrieve_next_frame_raw_data(Clip* c, AVFrame* output);
-bool is_clip_active(Clip* c, long playhead);
-void get_next_audio(Clip* c, bool mix);
-void set_sequence(Sequence* s);
-void closeActiveClips(Sequence* s, bool wait);
-
-struct ClipCacheData {
-	Clip& clip;
-	long playhead;
-	bool write_A;
-	bool write_B;
-	bool reset;
-};
-
-#endif // PLAYBACK_H
+#ifndef PLAYBACK_H
+#define PLAYBACK_H
+
+#include <QVector>
+#include <QMutex>
+
+struct Clip;
+struct ClipCache;
+struct Sequence;
+struct AVFrame;
+
+extern bool texture_failed;
+
+void open_clip(Clip* clip, bool multithreaded);
+void cache_clip(Clip* clip, long playhead, bool write_A, bool write_B, bool reset, Clip *nest);
+void close_clip(Clip* clip);
+void cache_audio_worker(Clip* c, bool write_A);
+void cache_video_worker(Clip* c, long playhead, ClipCache* cache);
+void handle_media(Sequence* sequence, long playhead, bool multithreaded);
+void reset_cache(Clip* c, long target_frame);
+void upload_clip_frame(Clip* c, AVFrame* frame);
+
+// the frame of c showing at playhead from its cache, starting the cacher on what comes next. NULL if it isn't there
+// yet. frame_id tells apart the frames of the clip, failed is set if the frame should have been cached but wasn't
+AVFrame* get_cached_frame(Clip* c, long playhead, long& frame_id, bool& failed);
+
+// get_cached_frame() uploaded into the clip's texture, sets texture_failed if the frame is missing
+bool get_clip_frame(Clip* c, long playhead);
+
+double playhead_to_seconds(Clip* c, long playhead);
+long seconds_to_clip_frame(Clip* c, double seconds);
+double clip_frame_to_seconds(Clip* c, long clip_frame);
+int retrieve_next_frame(Clip* c, AVFrame* f);
+void retrieve_next_frame_raw_data(Clip* c, AVFrame* output);
+bool is_clip_active(Clip* c, long playhead);
+
+// frame of a nested sequence shown by its clip when the sequence holding the clip is at playhead
+long nested_frame(Clip* nest, long playhead);
+
+// opens the clips of s (the ones on nest's side, if it's nested) showing at playhead and closes the rest, filling
+// current_clips with the open ones from the top track down. returns false if some footage hasn't finished loading
+bool get_active_clips(QVector<Clip*>& current_clips, Sequence* s, Clip* nest, long playhead, bool multithreaded, bool render_video);
+
+void get_next_audio(Clip* c, bool mix);
+void set_sequence(Sequence* s);
+void closeActiveClips(Sequence* s, bool wait);
+
+struct ClipCacheData {
+	Clip& clip;
+	long playhead;
+	bool write_A;
+	bool write_B;
+	bool reset;
+};
+
+#endif // PLAYBACK_H
@@ -0,0 +1,138 @@
+#include "rampreview.h"
+
+#include "project/sequence.h"
+#include "playback/audio.h"
+#include "panels/panels.h"
+#include "panels/timeline.h"
+#include "panels/viewer.h"
+#include "ui/viewerwidget.h"
+#include "io/config.h"
+
+#include <QProgressDialog>
+#include <QDebug>
+
+RamPreview ram_preview;
+
+RamPreview::RamPreview() :
+	range_in(0),
+	playing(false),
+	audio_write(0)
+{}
+
+void RamPreview::clear() {
+	playing = false;
+	frames.clear();
+	audio.clear();
+}
+
+bool RamPreview::is_playing() {
+	return playing && !frames.isEmpty();
+}
+
+void RamPreview::stop() {
+	playing = false;
+}
+
+void RamPreview::take_audio(int end) {
+	// move what the clips mixed for the frames drawn so far out of the ring buffer, leaving it free for more
+	while (audio_ibuffer_read < end) {
+		int index = audio_ibuffer_read % audio_ibuffer_size;
+		int length = qMin(end - audio_ibuffer_read, audio_ibuffer_size - index);
+		audio.append(reinterpret_cast<const char*>(audio_ibuffer + index), length);
+		memset(audio_ibuffer + index, 0, length);
+		audio_ibuffer_read += length;
+	}
+}
+
+void RamPreview::render(long in, long out) {
+	clear();
+	if (sequence == NULL || out <= in) return;
+
+	// uncompressed so playback never waits on decoding, which means the budget decides how much fits
+	qint64 frame_bytes = static_cast<qint64>(sequence->width) * sequence->height * 4;
+	long max_frames = (static_cast<qint64>(config.ram_preview_memory) << 20) / frame_bytes;
+	if (out - in > max_frames) {
+		qDebug() << "[INFO] RAM preview memory limit reached, only previewing" << max_frames << "frames";
+		out = in + max_frames;
+		if (out <= in) return;
+	}
+
+	panel_timeline->pause();
+	long old_playhead = sequence->playhead;
+
+	// the clips mix audio from the start of the range onwards as each frame is drawn
+	sequence->playhead = in;
+	panel_timeline->reset_all_audio();
+
+	QProgressDialog progress("Rendering RAM preview...", "Cancel", in, out, panel_timeline);
+	progress.setWindowModality(Qt::WindowModal);
+	progress.setMinimumDuration(0);
+
+	ViewerWidget* viewer = panel_viewer->viewer_widget;
+	viewer->start_offscreen_render(true);
+
+	frames.reserve(out - in);
+	for (long frame=in;frame<out && !progress.wasCanceled();frame++) {
+		progress.setValue(frame);
+
+		QImage image(sequence->width, sequence->height, QImage::Format_RGBA8888);
+		if (image.isNull()) {
+			qDebug() << "[WARNING] Ran out of memory for RAM preview after" << frames.size() << "frames";
+			break;
+		}
+
+		sequence->playhead = frame;
+		viewer->render_offscreen_frame(image);
+		frames.append(image);
+
+		take_audio(get_buffer_offset_from_frame(frame));
+	}
+	take_audio(get_buffer_offset_from_frame(in + frames.size()));
+
+	viewer->end_offscreen_render();
+
+	range_in = in;
+	sequence->playhead = old_playhead;
+	panel_timeline->reset_all_audio();
+	panel_timeline->repaint_timeline();
+}
+
+void RamPreview::play() {
+	if (frames.isEmpty()) return;
+
+	sequence->playhead = range_in;
+	panel_timeline->reset_all_audio();
+	audio_write = 0;
+	playing = true;
+	panel_timeline->play();
+}
+
+long RamPreview::get_loop_frame(long playhead) {
+	return range_in + (playhead - range_in) % frames.size();
+}
+
+QImage RamPreview::get_frame(long playhead) {
+	long index = playhead - range_in;
+	if (index < 0 || index >= frames.size()) return QImage();
+	return frames.at(index);
+}
+
+void RamPreview::send_audio() {
+	if (audio.isEmpty()) return;
+
+	audio_write_lock.lock();
+
+	// whatever the device played before we got here is skipped rather than played late, so sound stays on the clock
+	audio_write = qMax(audio_write, audio_ibuffer_read);
+
+	int limit = audio_ibuffer_read + audio_ibuffer_size;
+	while (audio_write < limit) {
+		int index = audio_write % audio_ibuffer_size;
+		int source = audio_write % audio.size();
+		int length = qMin(qMin(limit - audio_write, audio_ibuffer_size - index), audio.size() - source);
+		memcpy(audio_ibuffer + index, audio.constData() + source, length);
+		audio_write += length;
+	}
+
+	audio_write_lock.unlock();
+}
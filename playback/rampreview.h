@@ -0,0 +1,39 @@
+#ifndef RAMPREVIEW_H
+#define RAMPREVIEW_H
+
+#include <QObject>
+#include <QVector>
+#include <QImage>
+#include <QByteArray>
+
+// the work area rendered into memory along with its mixed audio, so it loops in real time however heavy it is to draw
+class RamPreview : public QObject {
+	Q_OBJECT
+public:
+	RamPreview();
+	void render(long in, long out);
+	void play();
+	void stop();
+	bool is_playing();
+
+	// playhead wrapped back into the rendered range
+	long get_loop_frame(long playhead);
+	QImage get_frame(long playhead);
+
+	// tops up the audio buffer from the premixed audio, called on every playback tick
+	void send_audio();
+public slots:
+	void clear();
+private:
+	void take_audio(int end);
+
+	QVector<QImage> frames;
+	QByteArray audio; // sequence-format samples matching the frames, loops along with them
+	long range_in;
+	bool playing;
+	int audio_write; // absolute audio buffer offset written up to, 0 is the start of the range
+};
+
+extern RamPreview ram_preview;
+
+#endif // RAMPREVIEW_H
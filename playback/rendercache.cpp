@@ -0,0 +1,247 @@
+#include "rendercache.h"
+
+#include "project/clip.h"
+#include "project/sequence.h"
+#include "io/media.h"
+#include "effects/effect.h"
+#include "effects/transition.h"
+#include "playback/playback.h"
+#include "panels/panels.h"
+#include "panels/timeline.h"
+#include "panels/viewer.h"
+#include "panels/project.h"
+#include "ui/viewerwidget.h"
+
+#include <QImage>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+#include <QCoreApplication>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QProgressDialog>
+#include <QDebug>
+
+#define RENDER_CACHE_QUALITY 90 // jpeg quality of cached frames
+#define RENDER_CACHE_DECODED_FRAMES 8 // decoded frames kept in memory
+
+RenderCache render_cache;
+
+void write_transition_state(QDataStream& stream, Transition* t) {
+	if (t == NULL) {
+		stream << -1;
+	} else {
+		stream << t->id << t->length;
+	}
+}
+
+void write_frame_state(QDataStream& stream, Sequence* s, long frame) {
+	for (int i=0;i<s->clips.size();i++) {
+		Clip* c = s->clips.at(i);
+
+		// only what compose_sequence would draw at this frame
+		if (c == NULL || c->track >= 0 || !is_clip_active(c, frame) || frame < c->timeline_in) continue;
+
+		stream << c->media_type << c->track << static_cast<qint64>(c->timeline_in) << static_cast<qint64>(c->timeline_out) << static_cast<qint64>(c->clip_in) << c->autoscale;
+
+		switch (c->media_type) {
+		case MEDIA_TYPE_FOOTAGE:
+			stream << static_cast<Media*>(c->media)->url << c->media_stream;
+			break;
+		case MEDIA_TYPE_SEQUENCE:
+		{
+			Sequence* nested = static_cast<Sequence*>(c->media);
+			stream << nested->width << nested->height;
+			write_frame_state(stream, nested, refactor_frame_number(frame + c->clip_in - c->timeline_in, s->frame_rate, nested->frame_rate));
+		}
+			break;
+		}
+
+		write_transition_state(stream, c->opening_transition);
+		write_transition_state(stream, c->closing_transition);
+
+		// keyframed values are written as their whole animation rather than their value at the playhead, so moving the
+		// playhead doesn't change the signature of every other frame
+		stream << c->effects.size();
+		for (int j=0;j<c->effects.size();j++) {
+			Effect* e = c->effects.at(j);
+			stream << e->id << e->is_enabled();
+			for (int k=0;k<e->row_count();k++) {
+				EffectRow* row = e->row(k);
+				stream << row->isKeyframing();
+				if (row->isKeyframing()) {
+					for (int l=0;l<row->keyframe_times.size();l++) {
+						stream << static_cast<qint64>(row->keyframe_times.at(l)) << row->keyframe_types.at(l);
+					}
+				}
+				for (int l=0;l<row->fieldCount();l++) {
+					EffectField* field = row->field(l);
+					if (row->isKeyframing() && field->keyframe_data.size() > 0) {
+						stream << field->keyframe_data;
+					} else {
+						stream << field->get_current_data();
+					}
+				}
+			}
+		}
+	}
+}
+
+QByteArray get_frame_signature(Sequence* s, long frame) {
+	QByteArray state;
+	QDataStream stream(&state, QIODevice::WriteOnly);
+	stream << s->width << s->height;
+	write_frame_state(stream, s, frame);
+	return QCryptographicHash::hash(state, QCryptographicHash::Md5);
+}
+
+RenderCache::RenderCache() {
+	decoded.setMaxCost(RENDER_CACHE_DECODED_FRAMES);
+}
+
+RenderCache::~RenderCache() {
+	if (!session_directory.isEmpty()) QDir(session_directory).removeRecursively();
+}
+
+void RenderCache::set_sequence(Sequence* s) {
+	frames.clear();
+	checked.clear();
+	decoded.clear();
+	directory.clear();
+	if (s == NULL) return;
+
+	QString cache_dir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+	if (cache_dir.isEmpty()) return;
+
+	if (project_url.isEmpty()) {
+		// unsaved projects all have the same (empty) url, so each sequence gets a folder of its own for this session
+		session_directory = cache_dir + "/render/unsaved-" + QString::number(QCoreApplication::applicationPid());
+		directory = session_directory + "/" + QString::number(reinterpret_cast<quintptr>(s), 16);
+	} else {
+		// one folder per project and sequence name, the signatures catch anything that changed between sessions
+		directory = cache_dir + "/render/" + QCryptographicHash::hash(QString(project_url + "/" + s->name).toUtf8(), QCryptographicHash::Md5).toHex();
+	}
+
+	// pick up frames rendered in an earlier session, their filenames carry the frame number and signature
+	QStringList files = QDir(directory).entryList(QStringList("*.jpg"), QDir::Files);
+	for (int i=0;i<files.size();i++) {
+		QString name = files.at(i);
+		name.chop(4);
+		int separator = name.indexOf('-');
+		bool ok;
+		long frame = name.left(separator).toLong(&ok);
+		if (separator > 0 && ok) frames[frame] = QByteArray::fromHex(name.mid(separator+1).toLatin1());
+	}
+}
+
+QString RenderCache::get_filename(long frame, const QByteArray& signature) {
+	return directory + "/" + QString::number(frame) + "-" + signature.toHex() + ".jpg";
+}
+
+QList<long> RenderCache::cached_frames() {
+	return frames.keys();
+}
+
+void RenderCache::remove_frame(long frame) {
+	QMap<long, QByteArray>::iterator i = frames.find(frame);
+	if (i != frames.end()) {
+		QFile::remove(get_filename(i.key(), i.value()));
+		frames.erase(i);
+	}
+	checked.remove(frame);
+	decoded.remove(frame);
+}
+
+void RenderCache::edit_changed() {
+	checked.clear();
+}
+
+bool RenderCache::check_frame(long frame) {
+	QMap<long, QByteArray>::iterator i = frames.find(frame);
+	if (i == frames.end()) return false;
+
+	// working out a signature means serializing the frame's whole state, so it's only done for frames that are
+	// actually wanted, once per change
+	if (!checked.contains(frame)) {
+		if (get_frame_signature(sequence, frame) != i.value()) {
+			remove_frame(frame);
+			return false;
+		}
+		checked.insert(frame);
+	}
+	return true;
+}
+
+bool RenderCache::get_frame(long frame, QImage& image) {
+	if (!check_frame(frame)) return false;
+	QMap<long, QByteArray>::iterator i = frames.find(frame);
+
+	QImage* cached = decoded.object(frame);
+	if (cached != NULL) {
+		image = *cached;
+		return true;
+	}
+
+	if (!image.load(get_filename(frame, i.value()))) {
+		qDebug() << "[WARNING] Could not read cached frame" << frame;
+		frames.erase(i);
+		checked.remove(frame);
+		return false;
+	}
+	image = image.convertToFormat(QImage::Format_RGBA8888);
+	decoded.insert(frame, new QImage(image));
+	return true;
+}
+
+void RenderCache::store_frame(long frame, const QImage& image) {
+	remove_frame(frame);
+
+	QByteArray signature = get_frame_signature(sequence, frame);
+	if (image.save(get_filename(frame, signature), "JPG", RENDER_CACHE_QUALITY)) {
+		frames[frame] = signature;
+		checked.insert(frame);
+	} else {
+		qDebug() << "[WARNING] Could not write cached frame" << frame;
+	}
+}
+
+void RenderCache::clear() {
+	if (!directory.isEmpty()) QDir(directory).removeRecursively();
+	frames.clear();
+	checked.clear();
+	decoded.clear();
+}
+
+void RenderCache::render(long in, long out) {
+	if (sequence == NULL || directory.isEmpty()) return;
+	if (!QDir().mkpath(directory)) {
+		qDebug() << "[ERROR] Could not create render cache folder" << directory;
+		return;
+	}
+
+	panel_timeline->pause();
+	long old_playhead = sequence->playhead;
+
+	QProgressDialog progress("Rendering...", "Cancel", in, out, panel_timeline);
+	progress.setWindowModality(Qt::WindowModal);
+	progress.setMinimumDuration(0);
+
+	ViewerWidget* viewer = panel_viewer->viewer_widget;
+	viewer->start_offscreen_render(false);
+
+	QImage image(sequence->width, sequence->height, QImage::Format_RGBA8888);
+	for (long frame=in;frame<out && !progress.wasCanceled();frame++) {
+		progress.setValue(frame);
+		if (check_frame(frame)) continue;
+
+		sequence->playhead = frame;
+		viewer->render_offscreen_frame(image);
+		store_frame(frame, image);
+	}
+
+	viewer->end_offscreen_render();
+
+	sequence->playhead = old_playhead;
+	panel_timeline->repaint_timeline();
+	viewer->update();
+}
@@ -0,0 +1,58 @@
+#ifndef RENDERCACHE_H
+#define RENDERCACHE_H
+
+#include <QObject>
+#include <QMap>
+#include <QSet>
+#include <QList>
+#include <QCache>
+#include <QImage>
+#include <QString>
+#include <QByteArray>
+struct Sequence;
+
+// hash of everything the picture of a sequence frame depends on, so a render can be checked against the current edit
+QByteArray get_frame_signature(Sequence* s, long frame);
+
+// frames of the active sequence rendered ahead of time and kept on disk, each with the signature it was rendered from
+class RenderCache : public QObject {
+	Q_OBJECT
+public:
+	RenderCache();
+	~RenderCache();
+	void set_sequence(Sequence* s);
+	void render(long in, long out);
+	void clear();
+
+	// frames rendered so far, including any an edit has changed that haven't been asked for or rendered over since
+	QList<long> cached_frames();
+
+	// only succeeds if the frame still matches the sequence as it is now
+	bool get_frame(long frame, QImage& image);
+public slots:
+	// for any change to the edit, through the undo stack or not. frames are checked again the next time they're asked
+	// for or rendered over rather than all at once, dropping the ones it changed
+	void edit_changed();
+private:
+	// true if frame is cached and still matches the sequence, removing it if it doesn't
+	bool check_frame(long frame);
+	QString get_filename(long frame, const QByteArray& signature);
+	void store_frame(long frame, const QImage& image);
+	void remove_frame(long frame);
+
+	QString directory;
+	QMap<long, QByteArray> frames;
+
+	// frames known to match the sequence since the last edit, so their signatures aren't worked out on every paint
+	QSet<long> checked;
+
+	// recently shown frames already decoded, so repaints and short loops don't read them from disk again
+	QCache<long, QImage> decoded;
+
+	// folder for unsaved projects' frames, which can't be found again once this session ends
+	QString session_directory;
+};
+
+extern RenderCache render_cache;
+
+#endif // RENDERCACHE_H
@@ -0,0 +1,313 @@
+#include "scrub.h"
+
+#include "project/clip.h"
+#include "project/sequence.h"
+#include "io/media.h"
+#include "playback/audio.h"
+#include "playback/playback.h"
+#include "effects/effect.h"
+
+extern "C" {
+	#include <libavformat/avformat.h>
+	#include <libavcodec/avcodec.h>
+	#include <libswresample/swresample.h>
+}
+
+#include <QtMath>
+#include <QDebug>
+
+#define SCRUB_GRAIN_LENGTH 0.06 // seconds of audio played per playhead move
+#define SCRUB_GRAIN_FADE 0.01 // raised cosine taper at each end of a grain so it doesn't click
+#define SCRUB_PREROLL 0.5 // decoded audio kept behind the playhead so scrubbing backwards rarely seeks
+#define SCRUB_SEEK_AHEAD 1.0 // reads further ahead than this seek instead of decoding up to them
+#define SCRUB_MAX_DECODERS 8
+
+ScrubThread* scrub_thread = NULL;
+
+ScrubDecoder::ScrubDecoder(const QString& iurl, int ifile_index) :
+	url(iurl),
+	file_index(ifile_index),
+	last_used(0),
+	formatCtx(NULL),
+	codecCtx(NULL),
+	swr_ctx(NULL),
+	frame(NULL),
+	pkt(NULL),
+	channels(0),
+	frequency(0),
+	reached_end(false),
+	pcm_start(-1)
+{}
+
+ScrubDecoder::~ScrubDecoder() {
+	av_packet_free(&pkt);
+	av_frame_free(&frame);
+	swr_free(&swr_ctx);
+	avcodec_free_context(&codecCtx);
+	if (formatCtx != NULL) avformat_close_input(&formatCtx);
+}
+
+bool ScrubDecoder::open(quint64 layout, int ifrequency) {
+	QByteArray ba = url.toUtf8();
+	const char* filename = ba.constData();
+
+	if (avformat_open_input(&formatCtx, filename, NULL, NULL) != 0) {
+		qDebug() << "[ERROR] Could not open" << filename << "for scrubbing";
+		return false;
+	}
+	if (avformat_find_stream_info(formatCtx, NULL) < 0 || file_index >= (int) formatCtx->nb_streams) {
+		qDebug() << "[ERROR] Could not find audio stream in" << filename << "for scrubbing";
+		return false;
+	}
+
+	AVStream* stream = formatCtx->streams[file_index];
+	AVCodec* codec = avcodec_find_decoder(stream->codecpar->codec_id);
+	if (codec == NULL) return false;
+	codecCtx = avcodec_alloc_context3(codec);
+	avcodec_parameters_to_context(codecCtx, stream->codecpar);
+	if (avcodec_open2(codecCtx, codec, NULL) < 0) {
+		qDebug() << "[ERROR] Could not open codec for scrubbing";
+		return false;
+	}
+
+	if (codecCtx->channel_layout == 0) {
+		codecCtx->channel_layout = guess_layout_from_channels(stream->codecpar->channels);
+	}
+
+	channels = av_get_channel_layout_nb_channels(layout);
+	frequency = ifrequency;
+	swr_ctx = swr_alloc_set_opts(
+			NULL,
+			layout,
+			AV_SAMPLE_FMT_S16,
+			frequency,
+			codecCtx->channel_layout,
+			codecCtx->sample_fmt,
+			codecCtx->sample_rate,
+			0,
+			NULL
+		);
+	if (swr_init(swr_ctx) < 0) {
+		qDebug() << "[ERROR] Could not initialize resampler for scrubbing";
+		return false;
+	}
+
+	frame = av_frame_alloc();
+	pkt = av_packet_alloc();
+	return true;
+}
+
+void ScrubDecoder::seek(qint64 sample) {
+	AVStream* stream = formatCtx->streams[file_index];
+	av_seek_frame(formatCtx, file_index, static_cast<int64_t>(qMax(0.0, (double) sample / frequency / av_q2d(stream->time_base))), AVSEEK_FLAG_BACKWARD);
+	avcodec_flush_buffers(codecCtx);
+	swr_close(swr_ctx);
+	swr_init(swr_ctx);
+	pcm.clear();
+	pcm_start = -1;
+	reached_end = false;
+}
+
+bool ScrubDecoder::decode_next() {
+	if (reached_end) return false;
+
+	int ret;
+	while ((ret = avcodec_receive_frame(codecCtx, frame)) == AVERROR(EAGAIN)) {
+		do {
+			av_packet_unref(pkt);
+			ret = av_read_frame(formatCtx, pkt);
+		} while (ret >= 0 && pkt->stream_index != file_index);
+
+		if (ret < 0 || avcodec_send_packet(codecCtx, pkt) < 0) {
+			reached_end = true;
+			return false;
+		}
+	}
+	if (ret < 0) {
+		reached_end = true;
+		return false;
+	}
+
+	if (pcm_start < 0) {
+		// anchor to the first frame's timestamp, everything after it is counted from here
+		pcm_start = (frame->pts == AV_NOPTS_VALUE) ? 0 : qRound64(frame->pts * av_q2d(formatCtx->streams[file_index]->time_base) * frequency);
+	}
+
+	int out_count = swr_get_out_samples(swr_ctx, frame->nb_samples);
+	int old_size = pcm.size();
+	pcm.resize(old_size + out_count*channels);
+	uint8_t* out = reinterpret_cast<uint8_t*>(pcm.data() + old_size);
+	int converted = swr_convert(swr_ctx, &out, out_count, const_cast<const uint8_t**>(frame->extended_data), frame->nb_samples);
+	pcm.resize(old_size + qMax(0, converted)*channels);
+	return true;
+}
+
+void ScrubDecoder::read(qint64 start, int nb_samples, qint16* out) {
+	qint64 pcm_end = pcm_start + pcm.size()/channels;
+	if (pcm_start < 0 || start < pcm_start || start > pcm_end + qRound64(SCRUB_SEEK_AHEAD * frequency)) {
+		seek(start - qRound64(SCRUB_PREROLL * frequency));
+	} else {
+		// drop anything too far behind to be useful for scrubbing backwards
+		qint64 keep_from = start - qRound64(SCRUB_PREROLL * frequency);
+		if (keep_from > pcm_start) {
+			int drop = qMin(static_cast<qint64>(pcm.size()/channels), keep_from - pcm_start);
+			pcm.remove(0, drop*channels);
+			pcm_start += drop;
+		}
+	}
+
+	while ((pcm_start < 0 || pcm_start + pcm.size()/channels < start + nb_samples) && decode_next()) {}
+
+	memset(out, 0, nb_samples*channels*sizeof(qint16));
+	if (pcm_start < 0) return;
+
+	// copy whatever part of the request we have, the rest stays silent
+	qint64 copy_start = qMax(start, pcm_start);
+	qint64 copy_end = qMin(start + nb_samples, pcm_start + pcm.size()/channels);
+	if (copy_end > copy_start) {
+		memcpy(out + (copy_start - start)*channels, pcm.constData() + (copy_start - pcm_start)*channels, (copy_end - copy_start)*channels*sizeof(qint16));
+	}
+}
+
+ScrubThread::ScrubThread(quint64 ilayout, int ifrequency) :
+	close(false),
+	pending(false),
+	layout(ilayout),
+	frequency(ifrequency),
+	grain_count(0)
+{
+	connect(this, SIGNAL(finished()), this, SLOT(deleteLater()));
+}
+
+void ScrubThread::stop() {
+	lock.lock();
+	close = true;
+	cond.wakeAll();
+	lock.unlock();
+	wait();
+}
+
+void ScrubThread::scrub(const QVector<ScrubSource>& sources) {
+	lock.lock();
+	pending_sources = sources;
+	pending = true;
+	cond.wakeAll();
+	lock.unlock();
+}
+
+void ScrubThread::run() {
+	lock.lock();
+	while (true) {
+		while (!pending && !close) cond.wait(&lock);
+		if (close) break;
+
+		QVector<ScrubSource> sources = pending_sources;
+		pending = false;
+
+		lock.unlock();
+		render_grain(sources);
+		lock.lock();
+	}
+	lock.unlock();
+
+	for (int i=0;i<decoders.size();i++) {
+		delete decoders.at(i);
+	}
+	decoders.clear();
+}
+
+ScrubDecoder* ScrubThread::get_decoder(const ScrubSource& source) {
+	for (int i=0;i<decoders.size();i++) {
+		ScrubDecoder* d = decoders.at(i);
+		if (d->file_index == source.file_index && d->url == source.url) {
+			d->last_used = grain_count;
+			return d;
+		}
+	}
+
+	// close the least recently used file if we have too many open
+	if (decoders.size() >= SCRUB_MAX_DECODERS) {
+		int oldest = 0;
+		for (int i=1;i<decoders.size();i++) {
+			if (decoders.at(i)->last_used < decoders.at(oldest)->last_used) oldest = i;
+		}
+		delete decoders.at(oldest);
+		decoders.removeAt(oldest);
+	}
+
+	ScrubDecoder* d = new ScrubDecoder(source.url, source.file_index);
+	if (!d->open(layout, frequency)) {
+		delete d;
+		return NULL;
+	}
+	d->last_used = grain_count;
+	decoders.append(d);
+	return d;
+}
+
+void ScrubThread::render_grain(const QVector<ScrubSource>& sources) {
+	grain_count++;
+
+	int channels = av_get_channel_layout_nb_channels(layout);
+	int nb_samples = qRound(SCRUB_GRAIN_LENGTH * frequency);
+	int fade_samples = qRound(SCRUB_GRAIN_FADE * frequency);
+
+	grain.fill(0, nb_samples*channels);
+	source_buffer.resize(nb_samples*channels);
+
+	for (int i=0;i<sources.size();i++) {
+		const ScrubSource& s = sources.at(i);
+		ScrubDecoder* d = get_decoder(s);
+		if (d == NULL) continue;
+
+		int source_samples = qMin(static_cast<qint64>(nb_samples), s.end_sample - s.start_sample);
+		if (source_samples <= 0) continue;
+
+		d->read(s.start_sample, source_samples, source_buffer.data());
+
+		for (int j=0;j<source_samples*channels;j++) {
+			grain[j] = mixAudioSample(grain.at(j), source_buffer.at(j));
+		}
+	}
+
+	// taper both ends
+	for (int i=0;i<fade_samples && i<nb_samples/2;i++) {
+		double gain = 0.5 - 0.5*qCos(M_PI * i / fade_samples);
+		qint16* head = grain.data() + i*channels;
+		qint16* tail = grain.data() + (nb_samples-i-1)*channels;
+		for (int j=0;j<channels;j++) {
+			head[j] = static_cast<qint16>(head[j] * gain);
+			tail[j] = static_cast<qint16>(tail[j] * gain);
+		}
+	}
+
+	queue_scrub_grain(grain);
+}
+
+void scrub_audio(long playhead) {
+	if (scrub_thread == NULL || sequence == NULL) return;
+
+	QVector<ScrubSource> sources;
+	for (int i=0;i<sequence->clips.size();i++) {
+		Clip* c = sequence->clips.at(i);
+		if (c != NULL
+				&& c->enabled
+				&& c->track >= 0
+				&& c->media_type == MEDIA_TYPE_FOOTAGE
+				&& c->timeline_in <= playhead
+				&& c->timeline_out > playhead) {
+			Media* m = static_cast<Media*>(c->media);
+			MediaStream* ms = m->get_stream_from_file_index(false, c->media_stream);
+			if (ms == NULL) continue;
+
+			ScrubSource s;
+			s.url = m->url;
+			s.file_index = ms->file_index;
+			s.start_sample = qRound64(playhead_to_seconds(c, playhead) * sequence->audio_frequency);
+			s.end_sample = qRound64(playhead_to_seconds(c, c->timeline_out) * sequence->audio_frequency);
+			sources.append(s);
+		}
+	}
+
+	scrub_thread->scrub(sources);
+}
@@ -0,0 +1,83 @@
+#ifndef SCRUB_H
+#define SCRUB_H
+
+#include <QThread>
+#include <QWaitCondition>
+#include <QMutex>
+#include <QVector>
+#include <QString>
+
+struct AVFormatContext;
+struct AVCodecContext;
+struct AVFrame;
+struct AVPacket;
+struct SwrContext;
+
+// one clip's contribution to a scrub grain, captured on the GUI thread so the scrub thread never touches clips
+struct ScrubSource {
+	QString url;
+	int file_index;
+	qint64 start_sample; // media position of the grain at the sequence's sample rate
+	qint64 end_sample; // first sample past the clip's out point
+};
+
+// keeps a file open along with the audio decoded around the last read, so most grains don't need a seek
+class ScrubDecoder {
+public:
+	ScrubDecoder(const QString& iurl, int ifile_index);
+	~ScrubDecoder();
+	bool open(quint64 layout, int frequency);
+	void read(qint64 start, int nb_samples, qint16* out);
+
+	QString url;
+	int file_index;
+	int last_used;
+private:
+	void seek(qint64 sample);
+	bool decode_next();
+
+	AVFormatContext* formatCtx;
+	AVCodecContext* codecCtx;
+	SwrContext* swr_ctx;
+	AVFrame* frame;
+	AVPacket* pkt;
+	int channels;
+	int frequency;
+	bool reached_end;
+
+	QVector<qint16> pcm; // decoded audio in the sequence's format
+	qint64 pcm_start; // sample index of the start of pcm, -1 until the first frame after a seek
+};
+
+class ScrubThread : public QThread {
+	Q_OBJECT
+public:
+	ScrubThread(quint64 ilayout, int ifrequency);
+	void run();
+	void stop();
+	void scrub(const QVector<ScrubSource>& sources);
+private:
+	void render_grain(const QVector<ScrubSource>& sources);
+	ScrubDecoder* get_decoder(const ScrubSource& source);
+
+	QWaitCondition cond;
+	QMutex lock;
+	bool close;
+
+	// only the most recent request is kept, anything the thread didn't get to is stale by now
+	QVector<ScrubSource> pending_sources;
+	bool pending;
+
+	quint64 layout;
+	int frequency;
+	QVector<ScrubDecoder*> decoders;
+	QVector<qint16> grain;
+	QVector<qint16> source_buffer;
+	int grain_count;
+};
+
+extern ScrubThread* scrub_thread;
+
+void scrub_audio(long playhead);
+
+#endif // SCRUB_H
@@ -1 +1 @@
-#include "marker.h"
+#include "marker.h"
@@ -1,11 +1,11 @@
-#ifndef MARKER_H
-#define MARKER_H
-
-#include <QString>
-
-struct Marker {
-    long frame;
-    QString name;
-};
-
-#endif // MARKER_H
+#ifndef MARKER_H
+#define MARKER_H
+
+#include <QString>
+
+struct Marker {
+    long frame;
+    QString name;
+};
+
+#endif // MARKER_H
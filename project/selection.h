@@ -1,16 +1,16 @@
-#ifndef SELECTION_H
-#define SELECTION_H
-
-struct Selection {
-	long in;
-	long out;
-	int track;
-
-	long old_in;
-	long old_out;
-	int old_track;
-
-	bool trim_in;
-};
-
-#endif // SELECTION_H
+#ifndef SELECTION_H
+#define SELECTION_H
+
+struct Selection {
+	long in;
+	long out;
+	int track;
+
+	long old_in;
+	long old_out;
+	int old_track;
+
+	bool trim_in;
+};
+
+#endif // SELECTION_H
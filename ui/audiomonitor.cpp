@@ -2,6 +2,7 @@
 
 #include "project/sequence.h"
 #include "playback/audio.h"
+#include "playback/audiometer.h"
 #include "panels/panels.h"
 #include "panels/timeline.h"
 
@@ -22,8 +23,6 @@ AudioMonitor::AudioMonitor(QWidget *parent) : QWidget(parent) {
 }
 
 void AudioMonitor::reset() {
-    sample_cache_offset = -1;
-    sample_cache.clear();
     update();
 }
 
@@ -40,56 +39,39 @@ void AudioMonitor::paintEvent(QPaintEvent *) {
         QPainter p(this);
         int channel_x = AUDIO_MONITOR_GAP;
 		int channel_count = av_get_channel_layout_nb_channels(sequence->audio_layout);
-		/*if (peaks.size() != channel_count) {
-            peaks.resize(channel_count);
-            peaks.fill(false);
-		}*/
         int channel_width = (width()/channel_count) - AUDIO_MONITOR_GAP;
-        long playhead_offset = -1;
-        int i;
-        for (i=0;i<channel_count;i++) {
+
+		// levels are metered on the audio sender thread, we only pick up the result for the current frame
+		AudioMeterBlock block;
+		bool metered = audio_meter.get_block(sequence->playhead, block);
+
+        for (int i=0;i<channel_count;i++) {
             QRect r(channel_x, AUDIO_MONITOR_PEAK_HEIGHT + AUDIO_MONITOR_GAP, channel_width, height());
             p.fillRect(r, gradient);
 
-			if (sample_cache_offset != -1 && sample_cache.size() > 0) {
-				playhead_offset = (sequence->playhead - sample_cache_offset) * channel_count;
-				if (playhead_offset >= 0 && playhead_offset < sample_cache.size()) {
-					double multiplier = 1 - qAbs((double) sample_cache.at(playhead_offset+i) / 32768.0); // 16-bit int divided to float
-					/*if (multiplier == (double) 0) {
-                        peaks[i] = true;
-					}*/
-                    r.setHeight(r.height()*multiplier);
-                } else {
-                    reset();
-                }
-            }
-
-			/*QRect peak_rect(channel_x, 0, channel_width, AUDIO_MONITOR_PEAK_HEIGHT);
-			if (peaks.at(i)) {
-                p.fillRect(peak_rect, QColor(255, 0, 0));
-            } else {
-                p.fillRect(peak_rect, QColor(64, 0, 0));
-			}*/
+			if (metered && i < block.channels) {
+				// darken everything above the peak
+				QRect peak_rect = r;
+				peak_rect.setHeight(r.height()*(1 - block.peak[i]));
+				p.fillRect(peak_rect, QColor(0, 0, 0, 160));
 
-            p.fillRect(r, QColor(0, 0, 0, 160));
+				// mark the rms level
+				int rms_y = r.top() + qRound(r.height()*(1 - block.rms[i]));
+				p.fillRect(QRect(channel_x, rms_y, channel_width, 1), Qt::white);
+			} else {
+				p.fillRect(r, QColor(0, 0, 0, 160));
+			}
 
             channel_x += channel_width + AUDIO_MONITOR_GAP;
         }
-        if (playhead_offset > -1) {
-            // clean up used samples
-            bool error = false;
-			while (sample_cache_offset < sequence->playhead && !error) {
-                sample_cache_offset++;
-                for (i=0;i<channel_count;i++) {
-                    if (sample_cache.isEmpty()) {
-                        reset();
-                        error = true;
-                        break;
-                    } else {
-                        sample_cache.removeFirst();
-                    }
-                }
-            }
-        }
+
+		// momentary loudness readout
+		QRect loudness_rect(0, 0, width(), AUDIO_MONITOR_PEAK_HEIGHT);
+		p.setPen(Qt::white);
+		if (metered && block.momentary_loudness > AUDIO_METER_MIN_LOUDNESS) {
+			p.drawText(loudness_rect, Qt::AlignCenter, QString::number(block.momentary_loudness, 'f', 1) + " LUFS");
+		} else {
+			p.drawText(loudness_rect, Qt::AlignCenter, "-inf LUFS");
+		}
     }
 }
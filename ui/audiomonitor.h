@@ -8,8 +8,6 @@ class AudioMonitor : public QWidget
     Q_OBJECT
 public:
     explicit AudioMonitor(QWidget *parent = 0);
-    QVector<qint16> sample_cache;
-    long sample_cache_offset;
     void reset();
 
 protected:
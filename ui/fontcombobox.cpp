@@ -1,21 +1,21 @@
-#include "fontcombobox.h"
-
-#include <QFontDatabase>
-
-FontCombobox::FontCombobox(QWidget* parent) : ComboBoxEx(parent) {
-	addItems(QFontDatabase().families());
-
-	value = currentText();
-
-	connect(this, SIGNAL(currentTextChanged(QString)), this, SLOT(updateInternals()));
-}
-
-const QString& FontCombobox::getPreviousValue() {
-	return previousValue;
-}
-
-void FontCombobox::updateInternals() {
-	qDebug() << "h";
-	previousValue = value;
-	value = currentText();
-}
+#include "fontcombobox.h"
+
+#include <QFontDatabase>
+
+FontCombobox::FontCombobox(QWidget* parent) : ComboBoxEx(parent) {
+	addItems(QFontDatabase().families());
+
+	value = currentText();
+
+	connect(this, SIGNAL(currentTextChanged(QString)), this, SLOT(updateInternals()));
+}
+
+const QString& FontCombobox::getPreviousValue() {
+	return previousValue;
+}
+
+void FontCombobox::updateInternals() {
+	qDebug() << "h";
+	previousValue = value;
+	value = currentText();
+}
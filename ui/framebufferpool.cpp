@@ -0,0 +1,73 @@
+#include "framebufferpool.h"
+
+#include <QOpenGLFramebufferObject>
+#include <QDebug>
+
+FramebufferPool::FramebufferPool() {}
+
+FramebufferPool::~FramebufferPool() {
+	if (targets.size() > 0) qDebug() << "[WARNING] Framebuffer pool destroyed without its context being current, GL resources leaked";
+}
+
+QOpenGLFramebufferObject* FramebufferPool::acquire(int width, int height, GLenum format) {
+	for (int i=0;i<targets.size();i++) {
+		PooledFramebuffer& t = targets[i];
+		if (!t.in_use && t.width == width && t.height == height && t.format == format) {
+			t.in_use = true;
+			t.idle_frames = 0;
+			return t.fbo;
+		}
+	}
+
+	PooledFramebuffer t;
+	t.fbo = new QOpenGLFramebufferObject(width, height, QOpenGLFramebufferObject::NoAttachment, GL_TEXTURE_2D, format);
+	t.width = width;
+	t.height = height;
+	t.format = format;
+	t.in_use = true;
+	t.retained = false;
+	t.idle_frames = 0;
+	targets.append(t);
+	return t.fbo;
+}
+
+void FramebufferPool::give_back(QOpenGLFramebufferObject* fbo) {
+	for (int i=0;i<targets.size();i++) {
+		if (targets.at(i).fbo == fbo) {
+			targets[i].in_use = false;
+			targets[i].retained = false;
+			return;
+		}
+	}
+	qDebug() << "[WARNING] Tried to return a framebuffer that didn't come from the pool";
+}
+
+void FramebufferPool::retain(QOpenGLFramebufferObject* fbo) {
+	for (int i=0;i<targets.size();i++) {
+		if (targets.at(i).fbo == fbo) {
+			targets[i].retained = true;
+			return;
+		}
+	}
+}
+
+void FramebufferPool::end_frame() {
+	for (int i=targets.size()-1;i>=0;i--) {
+		PooledFramebuffer& t = targets[i];
+		if (t.retained) {
+			t.idle_frames = 0;
+		} else if (t.in_use) {
+			t.in_use = false;
+		} else if (++t.idle_frames > FRAMEBUFFER_POOL_MAX_IDLE) {
+			delete t.fbo;
+			targets.removeAt(i);
+		}
+	}
+}
+
+void FramebufferPool::clear() {
+	for (int i=0;i<targets.size();i++) {
+		delete targets.at(i).fbo;
+	}
+	targets.clear();
+}
@@ -0,0 +1,40 @@
+#ifndef FRAMEBUFFERPOOL_H
+#define FRAMEBUFFERPOOL_H
+
+#include <QOpenGLFunctions>
+#include <QVector>
+
+class QOpenGLFramebufferObject;
+
+// targets nobody has borrowed for this many frames are deleted to give the memory back
+#define FRAMEBUFFER_POOL_MAX_IDLE 120
+
+struct PooledFramebuffer {
+	QOpenGLFramebufferObject* fbo;
+	int width;
+	int height;
+	GLenum format;
+	bool in_use;
+	bool retained;
+	int idle_frames;
+};
+
+// lends render targets out by (width, height, format) so compositing doesn't allocate a new pair for every clip.
+// targets are returned with give_back() once drawn from, and anything still out is returned by end_frame().
+// each GL context needs its own pool and it must be current for every call
+class FramebufferPool {
+public:
+	FramebufferPool();
+	~FramebufferPool();
+	QOpenGLFramebufferObject* acquire(int width, int height, GLenum format = GL_RGBA8);
+	void give_back(QOpenGLFramebufferObject* fbo);
+
+	// keeps a lent target out past the end of the frame, until it's given back
+	void retain(QOpenGLFramebufferObject* fbo);
+	void end_frame();
+	void clear();
+private:
+	QVector<PooledFramebuffer> targets;
+};
+
+#endif // FRAMEBUFFERPOOL_H
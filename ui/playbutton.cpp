@@ -1,9 +1,9 @@
-#include "playbutton.h"
-
-PlayButton::PlayButton(QWidget* parent) : QPushButton(parent)
-{
-	play_text = ">";
-	pause_text = "||";
-
-	setText(play_text);
-}
+#include "playbutton.h"
+
+PlayButton::PlayButton(QWidget* parent) : QPushButton(parent)
+{
+	play_text = ">";
+	pause_text = "||";
+
+	setText(play_text);
+}
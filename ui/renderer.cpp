@@ -0,0 +1,172 @@
+#include "renderer.h"
+
+#include "effects/effect.h"
+
+#include <QOpenGLShaderProgram>
+#include <QDebug>
+
+Renderer::Renderer() :
+	quad_buffer(QOpenGLBuffer::VertexBuffer),
+	line_buffer(QOpenGLBuffer::VertexBuffer),
+	composite_program(NULL),
+	line_program(NULL),
+	initialized(false)
+{}
+
+Renderer::~Renderer() {
+	if (initialized) qDebug() << "[WARNING] Renderer destroyed without its context being current, GL resources leaked";
+}
+
+bool Renderer::is_initialized() {
+	return initialized;
+}
+
+void Renderer::init() {
+	if (initialized) return;
+
+	initializeOpenGLFunctions();
+
+	// one static unit quad shared by every draw, the corners are moved into place by the vertex shader
+	static const GLfloat unit_quad[] = {
+		0, 0,
+		1, 0,
+		0, 1,
+		1, 1
+	};
+	quad_buffer.create();
+	quad_buffer.setUsagePattern(QOpenGLBuffer::StaticDraw);
+	quad_buffer.bind();
+	quad_buffer.allocate(unit_quad, sizeof(unit_quad));
+
+	// keep the attribute setup in a vertex array object where the context supports them
+	if (quad_vao.create()) {
+		quad_vao.bind();
+		glEnableVertexAttribArray(RENDERER_POSITION_ATTRIBUTE);
+		glVertexAttribPointer(RENDERER_POSITION_ATTRIBUTE, 2, GL_FLOAT, GL_FALSE, 0, 0);
+		quad_vao.release();
+	}
+	quad_buffer.release();
+
+	line_buffer.create();
+	line_buffer.setUsagePattern(QOpenGLBuffer::StreamDraw);
+
+	composite_program = new QOpenGLShaderProgram();
+	composite_program->addShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/common.vert");
+	composite_program->addShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/composite.frag");
+	composite_program->bindAttributeLocation("position", RENDERER_POSITION_ATTRIBUTE);
+	if (!composite_program->link()) qDebug() << "[ERROR] Failed to link compositing shader" << composite_program->log();
+
+	line_program = new QOpenGLShaderProgram();
+	line_program->addShaderFromSourceFile(QOpenGLShader::Vertex, ":/shaders/line.vert");
+	line_program->addShaderFromSourceFile(QOpenGLShader::Fragment, ":/shaders/line.frag");
+	line_program->bindAttributeLocation("position", RENDERER_POSITION_ATTRIBUTE);
+	if (!line_program->link()) qDebug() << "[ERROR] Failed to link line shader" << line_program->log();
+
+	initialized = true;
+}
+
+void Renderer::destroy() {
+	if (!initialized) return;
+
+	delete composite_program;
+	composite_program = NULL;
+	delete line_program;
+	line_program = NULL;
+
+	quad_vao.destroy();
+	quad_buffer.destroy();
+	line_buffer.destroy();
+
+	initialized = false;
+}
+
+void Renderer::set_blend_mode(int blend_mode) {
+	switch (blend_mode) {
+	case BLEND_MODE_NORMAL:
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		break;
+	case BLEND_MODE_OVERLAY:
+		glBlendFunc(GL_DST_COLOR, GL_SRC_ALPHA);
+		break;
+	case BLEND_MODE_SCREEN:
+		glBlendFunc(GL_ONE, GL_ONE_MINUS_SRC_COLOR);
+		break;
+	case BLEND_MODE_MULTIPLY:
+		glBlendFunc(GL_DST_COLOR, GL_ZERO);
+		break;
+	default:
+		qDebug() << "[ERROR] Invalid blend mode. This is a bug - please contact developers";
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	}
+}
+
+void Renderer::draw_quad(GLuint texture, const QMatrix4x4& projection, const GLTextureCoords& coords, QOpenGLShaderProgram* program, bool mipmap) {
+	bool own_program = (program == NULL);
+	if (own_program) {
+		program = composite_program;
+		program->bind();
+		program->setUniformValue("opacity", coords.opacity);
+	}
+
+	QVector2D vertex_corners[4] = {
+		QVector2D(coords.vertexTopLeftX, coords.vertexTopLeftY),
+		QVector2D(coords.vertexTopRightX, coords.vertexTopRightY),
+		QVector2D(coords.vertexBottomRightX, coords.vertexBottomRightY),
+		QVector2D(coords.vertexBottomLeftX, coords.vertexBottomLeftY)
+	};
+	QVector2D texture_corners[4] = {
+		QVector2D(coords.textureTopLeftX, coords.textureTopLeftY),
+		QVector2D(coords.textureTopRightX, coords.textureTopRightY),
+		QVector2D(coords.textureBottomRightX, coords.textureBottomRightY),
+		QVector2D(coords.textureBottomLeftX, coords.textureBottomLeftY)
+	};
+	program->setUniformValue("mvp_matrix", projection * coords.matrix);
+	program->setUniformValueArray("vertex_corners", vertex_corners, 4);
+	program->setUniformValueArray("texture_corners", texture_corners, 4);
+
+	set_blend_mode(coords.blend_mode);
+
+	glBindTexture(GL_TEXTURE_2D, texture);
+	if (mipmap) {
+		glGenerateMipmap(GL_TEXTURE_2D);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+	} else {
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	}
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	if (quad_vao.isCreated()) {
+		quad_vao.bind();
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+		quad_vao.release();
+	} else {
+		quad_buffer.bind();
+		glEnableVertexAttribArray(RENDERER_POSITION_ATTRIBUTE);
+		glVertexAttribPointer(RENDERER_POSITION_ATTRIBUTE, 2, GL_FLOAT, GL_FALSE, 0, 0);
+		glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+		glDisableVertexAttribArray(RENDERER_POSITION_ATTRIBUTE);
+		quad_buffer.release();
+	}
+
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	if (own_program) program->release();
+}
+
+void Renderer::draw_lines(const QVector<QVector2D>& points, const QMatrix4x4& projection, const QColor& color) {
+	line_program->bind();
+	line_program->setUniformValue("mvp_matrix", projection);
+	line_program->setUniformValue("color", color);
+
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	line_buffer.bind();
+	line_buffer.allocate(points.constData(), points.size() * sizeof(QVector2D));
+	glEnableVertexAttribArray(RENDERER_POSITION_ATTRIBUTE);
+	glVertexAttribPointer(RENDERER_POSITION_ATTRIBUTE, 2, GL_FLOAT, GL_FALSE, 0, 0);
+	glDrawArrays(GL_LINES, 0, points.size());
+	glDisableVertexAttribArray(RENDERER_POSITION_ATTRIBUTE);
+	line_buffer.release();
+
+	line_program->release();
+}
@@ -0,0 +1,47 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <QOpenGLFunctions>
+#include <QOpenGLBuffer>
+#include <QOpenGLVertexArrayObject>
+#include <QMatrix4x4>
+#include <QVector>
+#include <QVector2D>
+#include <QColor>
+
+class QOpenGLShaderProgram;
+struct GLTextureCoords;
+
+// every program drawn through the renderer reads the unit quad from this attribute location
+#define RENDERER_POSITION_ATTRIBUTE 0
+
+// draws textured quads and lines with shaders and vertex buffers rather than the fixed-function pipeline.
+// each GL context needs its own instance since buffers and programs are created in the current context
+class Renderer : protected QOpenGLFunctions {
+public:
+	Renderer();
+	~Renderer();
+	void init();
+	void destroy();
+	bool is_initialized();
+
+	// draws a texture over the corners in coords into whatever framebuffer is bound, using the coords' matrix,
+	// opacity and blend mode. if program is NULL the plain compositing shader is used, otherwise the caller
+	// is expected to have set the program's own uniforms already. mipmap regenerates the texture's mip chain first
+	// for programs that sample it at reduced resolution
+	void draw_quad(GLuint texture, const QMatrix4x4& projection, const GLTextureCoords& coords, QOpenGLShaderProgram* program = NULL, bool mipmap = false);
+
+	// pairs of points drawn as GL_LINES
+	void draw_lines(const QVector<QVector2D>& points, const QMatrix4x4& projection, const QColor& color);
+private:
+	void set_blend_mode(int blend_mode);
+
+	QOpenGLBuffer quad_buffer;
+	QOpenGLBuffer line_buffer;
+	QOpenGLVertexArrayObject quad_vao;
+	QOpenGLShaderProgram* composite_program;
+	QOpenGLShaderProgram* line_program;
+	bool initialized;
+};
+
+#endif // RENDERER_H
@@ -0,0 +1,384 @@
+#include "softwarerenderer.h"
+
+#include "project/clip.h"
+#include "project/sequence.h"
+#include "io/media.h"
+#include "effects/effect.h"
+#include "effects/transition.h"
+#include "playback/playback.h"
+
+extern "C" {
+	#include <libavformat/avformat.h>
+}
+
+#include <QtConcurrent>
+#include <QTransform>
+#include <QVector>
+#include <QtMath>
+#include <QDebug>
+
+struct SoftwareBand {
+	void (*kernel)(void*, int, int);
+	void* data;
+	int first_row;
+	int end_row;
+};
+
+void run_band(SoftwareBand& band) {
+	band.kernel(band.data, band.first_row, band.end_row);
+}
+
+void run_in_bands(int height, void (*kernel)(void*, int, int), void* data) {
+	QVector<SoftwareBand> bands;
+	for (int y=0;y<height;y+=SOFTWARE_BAND_HEIGHT) {
+		SoftwareBand band;
+		band.kernel = kernel;
+		band.data = data;
+		band.first_row = y;
+		band.end_row = qMin(y + SOFTWARE_BAND_HEIGHT, height);
+		bands.append(band);
+	}
+
+	if (bands.size() == 1) {
+		run_band(bands[0]);
+	} else {
+		QtConcurrent::blockingMap(bands, run_band);
+	}
+}
+
+// glBlendFunc() for each blend mode (see Renderer::set_blend_mode()), applied to all four channels in 0-255
+inline void blend_pixel(uchar* d, const float* s, int blend_mode) {
+	switch (blend_mode) {
+	case BLEND_MODE_SCREEN:
+		for (int c=0;c<4;c++) d[c] = float_to_byte(s[c] + d[c]*(1.0f - s[c]*(1.0f/255.0f)));
+		break;
+	case BLEND_MODE_MULTIPLY:
+		for (int c=0;c<4;c++) d[c] = float_to_byte(s[c]*d[c]*(1.0f/255.0f));
+		break;
+	case BLEND_MODE_OVERLAY:
+		for (int c=0;c<4;c++) d[c] = float_to_byte((s[c] + s[3])*d[c]*(1.0f/255.0f));
+		break;
+	default:
+	{
+		float a = s[3]*(1.0f/255.0f);
+		for (int c=0;c<4;c++) d[c] = float_to_byte(s[c]*a + d[c]*(1.0f - a));
+	}
+	}
+}
+
+struct BlendJob {
+	uchar* target;
+	int target_bpl;
+	const uchar* source;
+	int source_bpl;
+	int width;
+	int blend_mode;
+};
+
+void blend_rows(void* data, int first_row, int end_row) {
+	BlendJob* job = static_cast<BlendJob*>(data);
+	int count = job->width*4;
+	for (int y=first_row;y<end_row;y++) {
+		uchar* d = job->target + y*job->target_bpl;
+		const uchar* s = job->source + y*job->source_bpl;
+
+		// one loop per mode so each is straight arithmetic over the row
+		switch (job->blend_mode) {
+		case BLEND_MODE_SCREEN:
+			for (int i=0;i<count;i++) d[i] = float_to_byte(s[i] + d[i]*(1.0f - s[i]*(1.0f/255.0f)));
+			break;
+		case BLEND_MODE_MULTIPLY:
+			for (int i=0;i<count;i++) d[i] = float_to_byte(s[i]*d[i]*(1.0f/255.0f));
+			break;
+		case BLEND_MODE_OVERLAY:
+			for (int i=0;i<count;i++) d[i] = float_to_byte((s[i] + s[(i & ~3) + 3])*d[i]*(1.0f/255.0f));
+			break;
+		default:
+			for (int i=0;i<count;i++) {
+				float a = s[(i & ~3) + 3]*(1.0f/255.0f);
+				d[i] = float_to_byte(s[i]*a + d[i]*(1.0f - a));
+			}
+		}
+	}
+}
+
+void blend_image(QImage& target, const QImage& source, int blend_mode) {
+	BlendJob job;
+	job.target = target.bits();
+	job.target_bpl = target.bytesPerLine();
+	job.source = source.constBits();
+	job.source_bpl = source.bytesPerLine();
+	job.width = qMin(target.width(), source.width());
+	job.blend_mode = blend_mode;
+	run_in_bands(qMin(target.height(), source.height()), blend_rows, &job);
+}
+
+struct DrawJob {
+	uchar* target;
+	int target_bpl;
+	int target_width;
+	const uchar* source;
+	int source_bpl;
+	int source_width;
+	int source_height;
+	QTransform to_quad; // target pixel to its place across the quad being drawn, 0 to 1 both ways
+	QTransform to_source; // target pixel to source pixel
+	float opacity;
+	int blend_mode;
+};
+
+// GL_LINEAR with GL_CLAMP_TO_EDGE, at a point measured in source pixels
+inline void sample_bilinear(const DrawJob* job, double x, double y, float* color) {
+	x -= 0.5;
+	y -= 0.5;
+	int x0 = qFloor(x);
+	int y0 = qFloor(y);
+	float fx = x - x0;
+	float fy = y - y0;
+	int x1 = qBound(0, x0 + 1, job->source_width - 1) * 4;
+	int y1 = qBound(0, y0 + 1, job->source_height - 1);
+	x0 = qBound(0, x0, job->source_width - 1) * 4;
+	y0 = qBound(0, y0, job->source_height - 1);
+
+	const uchar* top = job->source + y0*job->source_bpl;
+	const uchar* bottom = job->source + y1*job->source_bpl;
+	for (int c=0;c<4;c++) {
+		float t = top[x0+c] + (top[x1+c] - top[x0+c])*fx;
+		float b = bottom[x0+c] + (bottom[x1+c] - bottom[x0+c])*fx;
+		color[c] = t + (b - t)*fy;
+	}
+}
+
+void draw_rows(void* data, int first_row, int end_row) {
+	DrawJob* job = static_cast<DrawJob*>(data);
+	float color[4];
+	for (int y=first_row;y<end_row;y++) {
+		uchar* d = job->target + y*job->target_bpl;
+		for (int x=0;x<job->target_width;x++) {
+			// like the rasterizer, a pixel is drawn if its centre is inside the quad
+			QPointF centre(x + 0.5, y + 0.5);
+			QPointF quad = job->to_quad.map(centre);
+			if (quad.x() >= 0 && quad.x() < 1 && quad.y() >= 0 && quad.y() < 1) {
+				QPointF texel = job->to_source.map(centre);
+				sample_bilinear(job, texel.x(), texel.y(), color);
+				color[3] *= job->opacity;
+				blend_pixel(d + x*4, color, job->blend_mode);
+			}
+		}
+	}
+}
+
+void draw_quad(QImage& target, const QImage& source, const QTransform& to_quad, const QTransform& to_source, float opacity, int blend_mode) {
+	DrawJob job;
+	job.target = target.bits();
+	job.target_bpl = target.bytesPerLine();
+	job.target_width = target.width();
+	job.source = source.constBits();
+	job.source_bpl = source.bytesPerLine();
+	job.source_width = source.width();
+	job.source_height = source.height();
+	job.to_quad = to_quad;
+	job.to_source = to_source;
+	job.opacity = opacity;
+	job.blend_mode = blend_mode;
+	run_in_bands(target.height(), draw_rows, &job);
+}
+
+void draw_image(QImage& target, const QImage& source, int blend_mode) {
+	if (target.size() == source.size()) {
+		blend_image(target, source, blend_mode);
+	} else {
+		QTransform to_quad = QTransform::fromScale(1.0 / target.width(), 1.0 / target.height());
+		QTransform to_source = QTransform::fromScale((double) source.width() / target.width(), (double) source.height() / target.height());
+		draw_quad(target, source, to_quad, to_source, 1.0, blend_mode);
+	}
+}
+
+// the final draw of a clip's layer into the sequence target, through the same mapping the viewer's projection and
+// quad make. corners are assumed to form a rectangle before coords.matrix, which every coordinate effect keeps to
+void draw_layer(QImage& target, const QImage& source, Sequence* s, const GLTextureCoords& coords) {
+	int half_width = s->width/2;
+	int half_height = s->height/2;
+	QTransform to_sequence(2.0*half_width/target.width(), 0, 0, 2.0*half_height/target.height(), -half_width, -half_height);
+
+	bool invertible;
+	QTransform from_sequence = coords.matrix.toTransform().inverted(&invertible);
+	double quad_width = coords.vertexTopRightX - coords.vertexTopLeftX;
+	double quad_height = coords.vertexBottomLeftY - coords.vertexTopLeftY;
+	if (!invertible || quad_width == 0 || quad_height == 0) return;
+
+	QTransform to_uv(1.0/quad_width, 0, 0, 1.0/quad_height, -coords.vertexTopLeftX/quad_width, -coords.vertexTopLeftY/quad_height);
+
+	int sw = source.width();
+	int sh = source.height();
+	QTransform uv_to_source(
+			(coords.textureTopRightX - coords.textureTopLeftX)*sw,
+			(coords.textureTopRightY - coords.textureTopLeftY)*sh,
+			(coords.textureBottomLeftX - coords.textureTopLeftX)*sw,
+			(coords.textureBottomLeftY - coords.textureTopLeftY)*sh,
+			coords.textureTopLeftX*sw,
+			coords.textureTopLeftY*sh
+		);
+
+	QTransform to_quad = to_sequence * from_sequence * to_uv;
+	draw_quad(target, source, to_quad, to_quad * uv_to_source, coords.opacity, coords.blend_mode);
+}
+
+bool SoftwareRenderer::render_frame(long playhead, QImage* image, double image_scale) {
+	scale = image_scale;
+	failed = false;
+
+	// the viewer clears to opaque black before drawing the sequence
+	if (image != NULL) image->fill(Qt::black);
+
+	compose_sequence(NULL, playhead, image);
+	return !failed;
+}
+
+int SoftwareRenderer::scaled_size(int size) {
+	return qMax(1, qRound(size*scale));
+}
+
+void SoftwareRenderer::compose_sequence(Clip* nest, long playhead, QImage* target) {
+	Sequence* s = (nest == NULL) ? sequence : static_cast<Sequence*>(nest->media);
+
+	QVector<Clip*> current_clips;
+	if (!get_active_clips(current_clips, s, nest, playhead, false, target != NULL)) failed = true;
+
+	for (int i=0;i<current_clips.size();i++) {
+		Clip* c = current_clips.at(i);
+
+		if (c->media_type == MEDIA_TYPE_FOOTAGE && !c->finished_opening) {
+			qDebug() << "[WARNING] Tried to display clip" << i << "but it's closed";
+			failed = true;
+		} else if (c->track < 0) {
+			if (playhead < c->timeline_in) continue;
+
+			int video_width = c->getWidth();
+			int video_height = c->getHeight();
+
+			QImage source;
+			if (c->media_type == MEDIA_TYPE_FOOTAGE) {
+				// straight out of the cache, which is already RGBA
+				c->target_decode_divisor = 1;
+				long frame_id;
+				AVFrame* frame = get_cached_frame(c, playhead, frame_id, failed);
+				if (frame == NULL || c->decode_divisor != 1) {
+					failed = true;
+					continue;
+				}
+				source = QImage(frame->data[0], frame->width, frame->height, frame->linesize[0], QImage::Format_RGBA8888);
+			} else if (c->media_type == MEDIA_TYPE_SEQUENCE) {
+				Sequence* nested = static_cast<Sequence*>(c->media);
+				source = QImage(scaled_size(nested->width), scaled_size(nested->height), QImage::Format_RGBA8888);
+				source.fill(Qt::transparent);
+				compose_sequence(c, nested_frame(c, playhead), &source);
+			}
+
+			bool draws_effects = (c->media_type == MEDIA_TYPE_SOLID);
+			for (int j=0;j<c->effects.size();j++) {
+				Effect* e = c->effects.at(j);
+				if (e->is_enabled() && (e->enable_shader || e->enable_superimpose)) draws_effects = true;
+			}
+
+			double timecode = ((double)(playhead-c->timeline_in+c->clip_in)/(double)s->frame_rate);
+
+			// the two targets the viewer ping-pongs effects between, each pass blending into the one it writes
+			QImage layer[2];
+			if (draws_effects) {
+				for (int j=0;j<2;j++) {
+					layer[j] = QImage(scaled_size(video_width), scaled_size(video_height), QImage::Format_RGBA8888);
+					layer[j].fill(Qt::transparent);
+				}
+				if (c->media_type != MEDIA_TYPE_SOLID) draw_image(layer[0], source, BLEND_MODE_NORMAL);
+			}
+
+			bool fbo_switcher = true;
+
+			GLTextureCoords coords;
+			coords.vertexTopLeftX = coords.vertexBottomLeftX = -video_width/2;
+			coords.vertexTopLeftY = coords.vertexTopRightY = -video_height/2;
+			coords.vertexTopRightX = coords.vertexBottomRightX = video_width/2;
+			coords.vertexBottomLeftY = coords.vertexBottomRightY = video_height/2;
+			coords.textureTopLeftY = coords.textureTopRightY = coords.textureTopLeftX = coords.textureBottomLeftX = 0;
+			coords.textureBottomLeftY = coords.textureBottomRightY = coords.textureTopRightX = coords.textureBottomRightX = 1.0;
+
+			if (c->autoscale && (video_width != s->width || video_height != s->height)) {
+				double width_multiplier = (double) s->width / (double) video_width;
+				double height_multiplier = (double) s->height / (double) video_height;
+				double scale_multiplier = qMin(width_multiplier, height_multiplier);
+				coords.matrix.scale(scale_multiplier, scale_multiplier);
+			}
+
+			for (int j=0;j<c->effects.size();j++) {
+				Effect* e = c->effects.at(j);
+				if (e->is_enabled()) {
+					if (e->enable_coords) {
+						e->process_coords(timecode, coords);
+					}
+					if (e->pointwise) {
+						// the whole run of per-pixel effects is one pass, as in the fused shader
+						QImage pass = layer[!fbo_switcher].copy();
+						e->process_image(timecode, pass, 0, scale);
+						while (j+1 < c->effects.size()) {
+							Effect* next = c->effects.at(j+1);
+							if (next->is_enabled()) {
+								if (next->pointwise) {
+									next->process_image(timecode, pass, 0, scale);
+								} else if (next->enable_shader || next->enable_superimpose) {
+									break;
+								} else if (next->enable_coords) {
+									next->process_coords(timecode, coords);
+								}
+							}
+							j++;
+						}
+						blend_image(layer[fbo_switcher], pass, BLEND_MODE_NORMAL);
+						fbo_switcher = !fbo_switcher;
+					} else if (e->enable_shader || e->enable_superimpose) {
+						for (int k=0;k<e->getIterations();k++) {
+							QImage pass = layer[!fbo_switcher].copy();
+							e->process_image(timecode, pass, k, scale);
+							blend_image(layer[fbo_switcher], pass, BLEND_MODE_NORMAL);
+							if (e->enable_superimpose) {
+								QImage superimpose = e->process_superimpose_image(timecode);
+								if (!superimpose.isNull()) draw_image(layer[fbo_switcher], superimpose, BLEND_MODE_NORMAL);
+							}
+							fbo_switcher = !fbo_switcher;
+						}
+					}
+				}
+			}
+
+			if (c->opening_transition != NULL) {
+				int transition_progress = playhead - c->timeline_in;
+				if (transition_progress < c->opening_transition->length) {
+					c->opening_transition->process_transition((double)transition_progress/(double)c->opening_transition->length, coords);
+				}
+			}
+
+			if (c->closing_transition != NULL) {
+				int transition_progress = c->closing_transition->length - (playhead - c->timeline_in - c->getLength() + c->closing_transition->length);
+				if (transition_progress < c->closing_transition->length) {
+					c->closing_transition->process_transition((double)transition_progress/(double)c->closing_transition->length, coords);
+				}
+			}
+
+			draw_layer(*target, (draws_effects) ? layer[!fbo_switcher] : source, s, coords);
+		} else {
+			switch (c->media_type) {
+			case MEDIA_TYPE_FOOTAGE:
+			case MEDIA_TYPE_TONE:
+				if (c->lock.tryLock()) {
+					// clip is not caching, start caching audio
+					cache_clip(c, playhead, false, false, c->audio_reset, nest);
+					c->lock.unlock();
+				}
+				break;
+			case MEDIA_TYPE_SEQUENCE:
+				compose_sequence(c, nested_frame(c, playhead), NULL);
+				break;
+			}
+		}
+	}
+}
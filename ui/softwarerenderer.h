@@ -0,0 +1,44 @@
+#ifndef SOFTWARERENDERER_H
+#define SOFTWARERENDERER_H
+
+#include <QImage>
+#include <QtGlobal>
+
+struct Clip;
+
+// rows each job of a software kernel covers, enough to keep every core busy while each band's rows stay in cache
+#define SOFTWARE_BAND_HEIGHT 32
+
+// splits rows 0 to height into bands and runs kernel(data, first_row, end_row) on them across the global thread pool.
+// kernels loop over whole rows with no branches in their inner loops, so the compiler can vectorize them
+void run_in_bands(int height, void (*kernel)(void*, int, int), void* data);
+
+// a channel worked out in 0-255 floating point stored back the way an 8-bit framebuffer rounds it
+inline uchar float_to_byte(float v) {
+	return static_cast<uchar>(qBound(0.0f, v + 0.5f, 255.0f));
+}
+
+// every image below is Format_RGBA8888 with unpremultiplied alpha, the same as the viewer's textures
+
+// blends source over target, both the same size, the way the viewer draws a pass filling a whole target
+void blend_image(QImage& target, const QImage& source, int blend_mode);
+
+// source stretched over the whole of target, blended the same way
+void draw_image(QImage& target, const QImage& source, int blend_mode);
+
+// draws frames of the current sequence without OpenGL, for machines with no GPU where a software implementation of it
+// would be far slower. follows ViewerWidget::compose_sequence() step for step, so its output matches a render from
+// the viewer within rounding. it keeps its own state rather than the viewer's globals, so it can run off the GUI thread
+class SoftwareRenderer {
+public:
+	// image is the size of the sequence times scale, or NULL if only the audio is needed. false if a clip's frame
+	// wasn't ready, in which case the frame has to be drawn again
+	bool render_frame(long playhead, QImage* image, double scale);
+private:
+	void compose_sequence(Clip* nest, long playhead, QImage* target);
+	int scaled_size(int size);
+	double scale;
+	bool failed;
+};
+
+#endif // SOFTWARERENDERER_H
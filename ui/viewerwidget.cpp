@@ -1,448 +1,685 @@
-#include "viewerwidget.h"
-
-#include "panels/panels.h"
-#include "panels/viewer.h"
-#include "panels/timeline.h"
-#include "panels/project.h"
-#include "project/sequence.h"
-#include "effects/effect.h"
-#include "effects/transition.h"
-#include "playback/playback.h"
-#include "playback/audio.h"
-#include "io/media.h"
-#include "ui_timeline.h"
-#include "playback/cacher.h"
-#include "io/config.h"
-
-#include <QDebug>
-#include <QPainter>
-#include <QAudioOutput>
-#include <QOpenGLShaderProgram>
-#include <QtMath>
-#include <QOpenGLFramebufferObject>
-#include <QOpenGLFunctions>
-
-extern "C" {
-	#include <libavformat/avformat.h>
-}
-
-ViewerWidget::ViewerWidget(QWidget *parent) :
-    QOpenGLWidget(parent),
-	rendering(false),
-	default_fbo(NULL)
-{
-	QSurfaceFormat format;
-	format.setDepthBufferSize(24);
-	setFormat(format);
-
-	// error handler - retries after 500ms if we couldn't get the entire image
-	retry_timer.setInterval(500);
-	connect(&retry_timer, SIGNAL(timeout()), this, SLOT(retry()));
-}
-
-void ViewerWidget::deleteFunction() {
-    // destroy all textures as well
-	makeCurrent();
-	closeActiveClips(sequence, true);
-	doneCurrent();
-}
-
-void ViewerWidget::retry() {
-	update();
-}
-
-void ViewerWidget::initializeGL() {
-	connect(context(), SIGNAL(aboutToBeDestroyed()), this, SLOT(deleteFunction()), Qt::DirectConnection);
-
-	retry_timer.start();
-}
-
-//void ViewerWidget::resizeGL(int w, int h)
-//{
-//}
-
-void ViewerWidget::paintEvent(QPaintEvent *e) {
-	if (!rendering) {
-		makeCurrent();
-		QOpenGLWidget::paintEvent(e);
-    }
-}
-
-void ViewerWidget::drawTitleSafeArea() {
-    double halfWidth = 0.5;
-    double halfHeight = 0.5;
-    double viewportAr = (double) width() / (double) height();
-    double halfAr = viewportAr*0.5;
-
-    if (config.use_custom_title_safe_ratio && config.custom_title_safe_ratio > 0) {
-        if (config.custom_title_safe_ratio > viewportAr) {
-            halfHeight = (config.custom_title_safe_ratio/viewportAr)*0.5;
-        } else {
-            halfWidth = (viewportAr/config.custom_title_safe_ratio)*0.5;
-        }
-    }
-
-    glLoadIdentity();
-    glOrtho(-halfWidth, halfWidth, halfHeight, -halfHeight, -1, 1);
-
-    glColor4f(0.5, 0.5, 0.5, 1.0);
-    glBegin(GL_LINES);
-
-    // action safe rectangle
-    glVertex2d(-0.45, -0.45);
-    glVertex2d(0.45, -0.45);
-    glVertex2d(0.45, -0.45);
-    glVertex2d(0.45, 0.45);
-    glVertex2d(0.45, 0.45);
-    glVertex2d(-0.45, 0.45);
-    glVertex2d(-0.45, 0.45);
-    glVertex2d(-0.45, -0.45);
-
-    // title safe rectangle
-    glVertex2d(-0.4, -0.4);
-    glVertex2d(0.4, -0.4);
-    glVertex2d(0.4, -0.4);
-    glVertex2d(0.4, 0.4);
-    glVertex2d(0.4, 0.4);
-    glVertex2d(-0.4, 0.4);
-    glVertex2d(-0.4, 0.4);
-    glVertex2d(-0.4, -0.4);
-
-    // horizontal centers
-    glVertex2d(-0.45, 0);
-    glVertex2d(-0.375, 0);
-    glVertex2d(0.45, 0);
-    glVertex2d(0.375, 0);
-
-    // vertical centers
-    glVertex2d(0, -0.45);
-    glVertex2d(0, -0.375);
-    glVertex2d(0, 0.45);
-    glVertex2d(0, 0.375);
-
-    glEnd();
-
-    // center cross
-    glLoadIdentity();
-    glOrtho(-halfAr, halfAr, 0.5, -0.5, -1, 1);
-
-    glBegin(GL_LINES);
-
-    glVertex2d(-0.05, 0);
-    glVertex2d(0.05, 0);
-    glVertex2d(0, -0.05);
-    glVertex2d(0, 0.05);
-
-    glEnd();
-}
-
-GLuint ViewerWidget::draw_clip(QOpenGLFramebufferObject* fbo, GLuint texture) {
-	glPushMatrix();
-	glLoadIdentity();
-	glOrtho(0, 1, 0, 1, -1, 1);
-
-	fbo->bind();
-
-	glBindTexture(GL_TEXTURE_2D, texture);
-	glBegin(GL_QUADS);
-	glTexCoord2f(0, 0); // top left
-	glVertex2f(0, 0); // top left
-	glTexCoord2f(1, 0); // top right
-	glVertex2f(1, 0); // top right
-	glTexCoord2f(1, 1); // bottom right
-	glVertex2f(1, 1); // bottom right
-	glTexCoord2f(0, 1); // bottom left
-	glVertex2f(0, 1); // bottom left
-	glEnd();
-	glBindTexture(GL_TEXTURE_2D, NULL);
-
-	fbo->release();
-	if (default_fbo != NULL) default_fbo->bind();
-
-	glPopMatrix();
-	return fbo->texture();
-}
-
-GLuint ViewerWidget::compose_sequence(Clip* nest, bool render_audio) {
-	Sequence* s = sequence;
-	long playhead = sequence->playhead;
-
-	if (nest != NULL) {
-		s = static_cast<Sequence*>(nest->media);
-		playhead += nest->clip_in - nest->timeline_in;
-		playhead = refactor_frame_number(playhead, nest->sequence->frame_rate, s->frame_rate);
-	}
-
-    QVector<Clip*> current_clips;
-
-    for (int i=0;i<s->clips.size();i++) {
-        Clip* c = s->clips.at(i);
-
-        // if clip starts within one second and/or hasn't finished yet
-		if (c != NULL && !(nest != NULL && !same_sign(c->track, nest->track))) {
-            bool clip_is_active = false;
-
-			switch (c->media_type) {
-			case MEDIA_TYPE_FOOTAGE:
-			{
-				Media* m = static_cast<Media*>(c->media);
-				if (m->ready) {
-					if (m->get_stream_from_file_index(c->track < 0, c->media_stream) != NULL
-							&& is_clip_active(c, playhead)) {
-						// if thread is already working, we don't want to touch this,
-						// but we also don't want to hang the UI thread
-						if (!c->open) {
-							open_clip(c, !rendering);
-						}
-						clip_is_active = true;
-					} else if (c->open) {
-						close_clip(c);
-					}
-				} else {
-					texture_failed = true;
-				}
-			}
-				break;
-			case MEDIA_TYPE_SEQUENCE:
-			case MEDIA_TYPE_SOLID:
-			case MEDIA_TYPE_TONE:
-				if (is_clip_active(c, playhead)) {
-					if (!c->open) open_clip(c, !rendering);
-					clip_is_active = true;
-				} else if (c->open) {
-					close_clip(c);
-				}
-				break;
-			}
-
-            if (clip_is_active) {
-                bool added = false;
-                for (int j=0;j<current_clips.size();j++) {
-                    if (current_clips.at(j)->track < c->track) {
-                        current_clips.insert(j, c);
-                        added = true;
-                        break;
-                    }
-                }
-                if (!added) {
-                    current_clips.append(c);
-                }
-            }
-        }
-    }
-
-	int half_width = s->width/2;
-	int half_height = s->height/2;
-	if (rendering || nest != NULL) half_height = -half_height;
-	glPushMatrix();
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-	glColor4f(1.0, 1.0, 1.0, 1.0);
-	glLoadIdentity();
-	glOrtho(-half_width, half_width, half_height, -half_height, -1, 1);
-
-    for (int i=0;i<current_clips.size();i++) {
-		Clip* c = current_clips.at(i);
-
-        if (c->media_type == MEDIA_TYPE_FOOTAGE && !c->finished_opening) {
-            qDebug() << "[WARNING] Tried to display clip" << i << "but it's closed";
-            texture_failed = true;
-        } else {
-			if (c->track < 0) {
-				glPushMatrix();
-
-				GLuint textureID = 0;
-				int video_width = c->getWidth();
-				int video_height = c->getHeight();
-
-				if (c->media_type == MEDIA_TYPE_FOOTAGE) {
-					get_clip_frame(c, playhead);
-					if (c->texture != NULL) textureID = c->texture->textureId();
-				} else if (c->media_type == MEDIA_TYPE_SEQUENCE) {
-					textureID = -1;
-				}
-
-				if (textureID == 0 && c->media_type != MEDIA_TYPE_SOLID) {
-					qDebug() << "[WARNING] Texture hasn't been created yet";
-					texture_failed = true;
-				} else if (playhead >= c->timeline_in) {
-					// start preparing cache
-					if (c->fbo == NULL) {
-						c->fbo = new QOpenGLFramebufferObject* [2];
-						c->fbo[0] = new QOpenGLFramebufferObject(video_width, video_height);
-						c->fbo[1] = new QOpenGLFramebufferObject(video_width, video_height);
-					}
-
-					// clear fbos
-					c->fbo[0]->bind();
-					glClear(GL_COLOR_BUFFER_BIT);
-					c->fbo[0]->release();
-					c->fbo[1]->bind();
-					glClear(GL_COLOR_BUFFER_BIT);
-					c->fbo[1]->release();
-
-					// for nested sequences
-					if (c->media_type == MEDIA_TYPE_SEQUENCE) textureID = compose_sequence(c, render_audio);
-
-					glViewport(0, 0, video_width, video_height);
-
-					GLuint composite_texture;
-					if (c->media_type == MEDIA_TYPE_SOLID) {
-						composite_texture = c->fbo[0]->texture();
-					} else {
-						composite_texture = draw_clip(c->fbo[0], textureID);
-					}
-
-					bool fbo_switcher = true;
-
-					GLTextureCoords coords;
-					coords.vertexTopLeftX = coords.vertexBottomLeftX = -video_width/2;
-					coords.vertexTopLeftY = coords.vertexTopRightY = -video_height/2;
-					coords.vertexTopRightX = coords.vertexBottomRightX = video_width/2;
-					coords.vertexBottomLeftY = coords.vertexBottomRightY = video_height/2;
-					coords.textureTopLeftY = coords.textureTopRightY = coords.textureTopLeftX = coords.textureBottomLeftX = 0;
-					coords.textureBottomLeftY = coords.textureBottomRightY = coords.textureTopRightX = coords.textureBottomRightX = 1.0;					
-
-					if (c->autoscale && (video_width != s->width || video_height != s->height)) {
-						double width_multiplier = (double) s->width / (double) video_width;
-						double height_multiplier = (double) s->height / (double) video_height;
-						double scale_multiplier = qMin(width_multiplier, height_multiplier);
-						glScalef(scale_multiplier, scale_multiplier, 1);
-					}
-
-					// EFFECT CODE START
-					for (int j=0;j<c->effects.size();j++) {
-						Effect* e = c->effects.at(j);
-						if (e->is_enabled()) {
-							double timecode = ((double)(sequence->playhead-c->timeline_in+c->clip_in)/(double)sequence->frame_rate);
-							if (e->enable_coords) {
-								e->process_coords(timecode, coords);
-							}
-							if (e->enable_shader || e->enable_superimpose) {
-								e->startEffect();
-								for (int k=0;k<e->getIterations();k++) {
-									e->process_shader(timecode);
-									composite_texture = draw_clip(c->fbo[fbo_switcher], composite_texture);
-									if (e->enable_superimpose) {
-										GLuint superimpose_texture = e->process_superimpose(timecode);
-										if (superimpose_texture != 0) draw_clip(c->fbo[fbo_switcher], superimpose_texture);
-									}
-									fbo_switcher = !fbo_switcher;
-								}
-							}
-						}
-					}
-
-					if (c->opening_transition != NULL) {
-						int transition_progress = playhead - c->timeline_in;
-						if (transition_progress < c->opening_transition->length) {
-							c->opening_transition->process_transition((double)transition_progress/(double)c->opening_transition->length);
-						}
-					}
-
-					if (c->closing_transition != NULL) {
-						int transition_progress = c->closing_transition->length - (playhead - c->timeline_in - c->getLength() + c->closing_transition->length);
-						if (transition_progress < c->closing_transition->length) {
-							c->closing_transition->process_transition((double)transition_progress/(double)c->closing_transition->length);
-						}
-					}
-
-					for (int j=0;j<c->effects.size();j++) {
-						if ((c->effects.at(j)->enable_shader || c->effects.at(j)->enable_superimpose) && c->effects.at(j)->is_enabled()) {
-							c->effects.at(j)->endEffect();
-						}
-					}
-					// EFFECT CODE END
-
-					if (nest != NULL) {
-						nest->fbo[0]->bind();
-						glViewport(0, 0, s->width, s->height);
-					} else if (rendering) {
-						glViewport(0, 0, s->width, s->height);
-					} else {
-						glViewport(0, 0, width(), height());
-					}
-
-					glBindTexture(GL_TEXTURE_2D, composite_texture);
-
-					glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-					glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-					glBegin(GL_QUADS);
-					glTexCoord2f(coords.textureTopLeftX, coords.textureTopLeftY); // top left
-					glVertex2f(coords.vertexTopLeftX, coords.vertexTopLeftY); // top left
-					glTexCoord2f(coords.textureTopRightX, coords.textureTopRightY); // top right
-					glVertex2f(coords.vertexTopRightX, coords.vertexTopRightY); // top right
-					glTexCoord2f(coords.textureBottomRightX, coords.textureBottomRightY); // bottom right
-					glVertex2f(coords.vertexBottomRightX, coords.vertexBottomRightY); // bottom right
-					glTexCoord2f(coords.textureBottomLeftX, coords.textureBottomLeftY); // bottom left
-					glVertex2f(coords.vertexBottomLeftX, coords.vertexBottomLeftY); // bottom left
-					glEnd();
-
-					if (nest != NULL) {
-						nest->fbo[0]->release();
-						if (default_fbo != NULL) default_fbo->bind();
-					}
-				}
-
-				glPopMatrix();
-			} else {
-				switch (c->media_type) {
-				case MEDIA_TYPE_FOOTAGE:
-				case MEDIA_TYPE_TONE:
-					if (render_audio
-							&& c->lock.tryLock()) {
-						// clip is not caching, start caching audio
-						cache_clip(c, playhead, false, false, c->audio_reset, nest);
-						c->lock.unlock();
-					}
-					break;
-				case MEDIA_TYPE_SEQUENCE:
-					compose_sequence(c, render_audio);
-					break;
-				}
-			}
-        }
-    }
-
-	glPopMatrix();
-
-	return (nest != NULL && nest->fbo != NULL) ? nest->fbo[0]->texture() : 0;
-}
-
-void ViewerWidget::paintGL() {
-	bool loop = false;
-	do {
-		loop = false;
-
-		glClearColor(0, 0, 0, 1);
-		glMatrixMode(GL_PROJECTION);
-		glEnable(GL_TEXTURE_2D);
-		glEnable(GL_BLEND);
-
-        texture_failed = false;
-
-		if (!rendering) retry_timer.stop();
-
-        glClear(GL_COLOR_BUFFER_BIT);
-
-		// compose video preview
-		glClearColor(0, 0, 0, 0);
-		compose_sequence(NULL, (panel_timeline->playing || rendering));
-
-        if (texture_failed) {
-			if (rendering) {
-				qDebug() << "[INFO] Texture failed - looping";
-				loop = true;
-            } else {
-				retry_timer.start();
-            }
-        }
-
-        if (config.show_title_safe_area && !rendering) {
-            drawTitleSafeArea();
-        }
-
-		glDisable(GL_BLEND);
-		glDisable(GL_TEXTURE_2D);
-	} while (loop);
-}
+#include "viewerwidget.h"
+
+#include "panels/panels.h"
+#include "panels/viewer.h"
+#include "panels/timeline.h"
+#include "panels/project.h"
+#include "project/sequence.h"
+#include "effects/effect.h"
+#include "effects/transition.h"
+#include "playback/playback.h"
+#include "playback/audio.h"
+#include "io/media.h"
+#include "ui_timeline.h"
+#include "playback/cacher.h"
+#include "playback/rendercache.h"
+#include "playback/rampreview.h"
+#include "io/config.h"
+
+#include <QDebug>
+#include <QPainter>
+#include <QImage>
+#include <QAudioOutput>
+#include <QOpenGLShaderProgram>
+#include <QtMath>
+#include <QOpenGLFramebufferObject>
+#include <QOpenGLFunctions>
+#include <QLineF>
+
+extern "C" {
+	#include <libavformat/avformat.h>
+}
+
+#define MAX_DECODE_DIVISOR 8 // footage is never converted smaller than an eighth of its size
+#define DECODE_SCALE_MARGIN 1.25 // how far past a smaller size a clip has to shrink before it's decoded at it
+
+// target pixels covered by each pixel of a width x height texture drawn with coords, along whichever axis is larger
+double get_display_scale(const GLTextureCoords& coords, int width, int height) {
+	QPointF top_left = coords.matrix.map(QPointF(coords.vertexTopLeftX, coords.vertexTopLeftY));
+	QPointF top_right = coords.matrix.map(QPointF(coords.vertexTopRightX, coords.vertexTopRightY));
+	QPointF bottom_left = coords.matrix.map(QPointF(coords.vertexBottomLeftX, coords.vertexBottomLeftY));
+	double texture_width = qAbs(coords.textureTopRightX - coords.textureTopLeftX) * width;
+	double texture_height = qAbs(coords.textureBottomLeftY - coords.textureTopLeftY) * height;
+	if (texture_width <= 0 || texture_height <= 0) return 0;
+	return qMax(QLineF(top_left, top_right).length() / texture_width, QLineF(top_left, bottom_left).length() / texture_height);
+}
+
+// largest power of two footage can be shrunk by and still have a pixel for every pixel it's shown at
+int get_decode_divisor(double scale) {
+	int divisor = 1;
+	while (divisor < MAX_DECODE_DIVISOR && scale*divisor*2 <= 1.0) divisor *= 2;
+	return divisor;
+}
+
+ViewerWidget::ViewerWidget(QWidget *parent) :
+    QOpenGLWidget(parent),
+	rendering(false),
+	skip_audio(false),
+	default_fbo(NULL),
+	cached_frame_texture(NULL),
+	offscreen_fbo(NULL)
+{
+	QSurfaceFormat format;
+	format.setDepthBufferSize(24);
+	setFormat(format);
+
+	// error handler - retries after 500ms if we couldn't get the entire image
+	retry_timer.setInterval(500);
+	connect(&retry_timer, SIGNAL(timeout()), this, SLOT(retry()));
+}
+
+void ViewerWidget::deleteFunction() {
+    // destroy all textures as well
+	makeCurrent();
+	closeActiveClips(sequence, true);
+	clear_shader_programs();
+	delete cached_frame_texture;
+	cached_frame_texture = NULL;
+	layer_cache.clear();
+	nest_cache.clear();
+	fbo_pool.clear();
+	renderer.destroy();
+	doneCurrent();
+}
+
+void ViewerWidget::retry() {
+	update();
+}
+
+void ViewerWidget::initializeGL() {
+	connect(context(), SIGNAL(aboutToBeDestroyed()), this, SLOT(deleteFunction()), Qt::DirectConnection);
+
+	renderer.init();
+
+	retry_timer.start();
+}
+
+//void ViewerWidget::resizeGL(int w, int h)
+//{
+//}
+
+void ViewerWidget::paintEvent(QPaintEvent *e) {
+	if (!rendering) {
+		makeCurrent();
+		QOpenGLWidget::paintEvent(e);
+    }
+}
+
+void ViewerWidget::drawTitleSafeArea() {
+    double halfWidth = 0.5;
+    double halfHeight = 0.5;
+    double viewportAr = (double) width() / (double) height();
+    double halfAr = viewportAr*0.5;
+
+    if (config.use_custom_title_safe_ratio && config.custom_title_safe_ratio > 0) {
+        if (config.custom_title_safe_ratio > viewportAr) {
+            halfHeight = (config.custom_title_safe_ratio/viewportAr)*0.5;
+        } else {
+            halfWidth = (viewportAr/config.custom_title_safe_ratio)*0.5;
+        }
+    }
+
+    QMatrix4x4 projection;
+    projection.ortho(-halfWidth, halfWidth, halfHeight, -halfHeight, -1, 1);
+
+    QVector<QVector2D> lines;
+
+    // action safe rectangle
+    lines << QVector2D(-0.45, -0.45) << QVector2D(0.45, -0.45);
+    lines << QVector2D(0.45, -0.45) << QVector2D(0.45, 0.45);
+    lines << QVector2D(0.45, 0.45) << QVector2D(-0.45, 0.45);
+    lines << QVector2D(-0.45, 0.45) << QVector2D(-0.45, -0.45);
+
+    // title safe rectangle
+    lines << QVector2D(-0.4, -0.4) << QVector2D(0.4, -0.4);
+    lines << QVector2D(0.4, -0.4) << QVector2D(0.4, 0.4);
+    lines << QVector2D(0.4, 0.4) << QVector2D(-0.4, 0.4);
+    lines << QVector2D(-0.4, 0.4) << QVector2D(-0.4, -0.4);
+
+    // horizontal centers
+    lines << QVector2D(-0.45, 0) << QVector2D(-0.375, 0);
+    lines << QVector2D(0.45, 0) << QVector2D(0.375, 0);
+
+    // vertical centers
+    lines << QVector2D(0, -0.45) << QVector2D(0, -0.375);
+    lines << QVector2D(0, 0.45) << QVector2D(0, 0.375);
+
+    QColor line_color = QColor::fromRgbF(0.5, 0.5, 0.5);
+    renderer.draw_lines(lines, projection, line_color);
+
+    // center cross
+    projection.setToIdentity();
+    projection.ortho(-halfAr, halfAr, 0.5, -0.5, -1, 1);
+
+    lines.clear();
+    lines << QVector2D(-0.05, 0) << QVector2D(0.05, 0);
+    lines << QVector2D(0, -0.05) << QVector2D(0, 0.05);
+
+    renderer.draw_lines(lines, projection, line_color);
+}
+
+QVector<QVariant> ViewerWidget::layer_signature(Clip* c, double timecode, int width, int height) {
+	QVector<QVariant> signature;
+
+	switch (c->media_type) {
+	case MEDIA_TYPE_FOOTAGE:
+		if (c->texture == NULL) return signature;
+		signature.append(static_cast<qulonglong>(c->texture->textureId()));
+		signature.append(static_cast<qlonglong>(c->texture_frame));
+		signature.append(c->decode_divisor);
+		break;
+	case MEDIA_TYPE_SOLID:
+		break;
+	default:
+		// a nested sequence would need its whole subtree compared, so it's always redrawn
+		return signature;
+	}
+
+	signature.append(width);
+	signature.append(height);
+
+	for (int i=0;i<c->effects.size();i++) {
+		Effect* e = c->effects.at(i);
+		if (e->is_enabled() && (e->enable_shader || e->enable_superimpose)) {
+			signature.append(e->id);
+			for (int j=0;j<e->row_count();j++) {
+				EffectRow* row = e->row(j);
+				for (int k=0;k<row->fieldCount();k++) {
+					EffectField* field = row->field(k);
+					field->validate_keyframe_data(timecode);
+					signature.append(field->get_current_data());
+				}
+			}
+		}
+	}
+
+	return signature;
+}
+
+void ViewerWidget::prune_layer_cache() {
+	// clips that weren't drawn this frame give their cached output back to the pool
+	QHash<LayerKey, LayerCache>::iterator i = layer_cache.begin();
+	while (i != layer_cache.end()) {
+		if (i.value().used) {
+			i.value().used = false;
+			i++;
+		} else {
+			fbo_pool.give_back(i.value().fbo);
+			i = layer_cache.erase(i);
+		}
+	}
+}
+
+void ViewerWidget::prune_nest_cache() {
+	QHash<QPair<Sequence*, long>, NestCache>::iterator i = nest_cache.begin();
+	while (i != nest_cache.end()) {
+		if (i.value().used) {
+			i.value().used = false;
+			i++;
+		} else {
+			fbo_pool.give_back(i.value().fbo);
+			i = nest_cache.erase(i);
+		}
+	}
+}
+
+QOpenGLFramebufferObject* ViewerWidget::compose_nest(Clip* c, long frame, bool render_audio, bool& cached) {
+	Sequence* s = static_cast<Sequence*>(c->media);
+	QPair<Sequence*, long> key(s, frame);
+	cached = true;
+
+	// previews may have drawn footage a frame or two off while it decoded, so only rendered output is good enough for a render
+	QByteArray signature;
+	if (nest_cache.contains(key) && (nest_cache[key].exact || !rendering) && nest_cache[key].scale == render_scale) {
+		NestCache& entry = nest_cache[key];
+
+		// already checked against the edit earlier in this frame
+		if (entry.used) return entry.fbo;
+
+		signature = get_frame_signature(s, frame);
+		if (entry.signature == signature) {
+			entry.used = true;
+			return entry.fbo;
+		}
+	}
+
+	QOpenGLFramebufferObject* fbo = fbo_pool.acquire(get_render_size(s->width), get_render_size(s->height));
+	fbo->bind();
+	glClear(GL_COLOR_BUFFER_BIT);
+	fbo->release();
+
+	bool failed = texture_failed;
+	texture_failed = false;
+	compose_sequence(c, frame, render_audio, fbo);
+	cached = !texture_failed;
+	texture_failed = texture_failed || failed;
+
+	// anything missing a texture or drawn from footage still waiting on its scaler to reopen at another size gets drawn
+	// again next frame, so it isn't kept. a hit skips compose_sequence(), so one kept half-res would never be replaced
+	if (cached) {
+		if (signature.isEmpty()) signature = get_frame_signature(s, frame);
+		if (nest_cache.contains(key)) fbo_pool.give_back(nest_cache[key].fbo);
+		fbo_pool.retain(fbo);
+		NestCache& entry = nest_cache[key];
+		entry.signature = signature;
+		entry.fbo = fbo;
+		entry.exact = rendering;
+		entry.scale = render_scale;
+		entry.used = true;
+	}
+
+	return fbo;
+}
+
+void ViewerWidget::start_offscreen_render(bool audio) {
+	makeCurrent();
+
+	// clips reopen synchronously while rendering, so every frame waits for its textures
+	closeActiveClips(sequence, true);
+
+	offscreen_fbo = new QOpenGLFramebufferObject(sequence->width, sequence->height);
+	rendering = true;
+	skip_audio = !audio;
+	default_fbo = offscreen_fbo;
+}
+
+void ViewerWidget::render_offscreen_frame(QImage& image) {
+	// anything repainting in between, like a progress dialog, may have switched contexts
+	makeCurrent();
+	offscreen_fbo->bind();
+
+	paintGL();
+	glReadPixels(0, 0, sequence->width, sequence->height, GL_RGBA, GL_UNSIGNED_BYTE, image.bits());
+}
+
+void ViewerWidget::end_offscreen_render() {
+	makeCurrent();
+	default_fbo = NULL;
+	skip_audio = false;
+	rendering = false;
+	delete offscreen_fbo;
+	offscreen_fbo = NULL;
+
+	// let playback reopen the clips in the background
+	closeActiveClips(sequence, true);
+	doneCurrent();
+}
+
+bool ViewerWidget::draw_cached_frame() {
+	QImage image;
+	if (!render_cache.get_frame(sequence->playhead, image)) return false;
+	draw_frame_image(image);
+	return true;
+}
+
+void ViewerWidget::draw_frame_image(const QImage& image) {
+	if (cached_frame_texture == NULL || cached_frame_texture->width() != image.width() || cached_frame_texture->height() != image.height()) {
+		delete cached_frame_texture;
+		cached_frame_texture = new QOpenGLTexture(QOpenGLTexture::Target2D);
+		cached_frame_texture->setSize(image.width(), image.height());
+		cached_frame_texture->setFormat(QOpenGLTexture::RGBA8_UNorm);
+		cached_frame_texture->setMipLevels(1);
+		cached_frame_texture->setMinMagFilters(QOpenGLTexture::Linear, QOpenGLTexture::Linear);
+		cached_frame_texture->setWrapMode(QOpenGLTexture::ClampToEdge);
+		cached_frame_texture->allocateStorage(QOpenGLTexture::RGBA, QOpenGLTexture::UInt8);
+	}
+	cached_frame_texture->setData(0, QOpenGLTexture::RGBA, QOpenGLTexture::UInt8, image.constBits());
+
+	int half_width = sequence->width/2;
+	int half_height = sequence->height/2;
+	QMatrix4x4 projection;
+	projection.ortho(-half_width, half_width, half_height, -half_height, -1, 1);
+
+	GLTextureCoords coords;
+	coords.vertexTopLeftX = coords.vertexBottomLeftX = -half_width;
+	coords.vertexTopLeftY = coords.vertexTopRightY = -half_height;
+	coords.vertexTopRightX = coords.vertexBottomRightX = half_width;
+	coords.vertexBottomLeftY = coords.vertexBottomRightY = half_height;
+	coords.textureTopLeftX = coords.textureBottomLeftX = coords.textureTopLeftY = coords.textureTopRightY = 0;
+	coords.textureTopRightX = coords.textureBottomRightX = coords.textureBottomLeftY = coords.textureBottomRightY = 1;
+
+	glViewport(0, 0, width(), height());
+	renderer.draw_quad(cached_frame_texture->textureId(), projection, coords);
+}
+
+GLuint ViewerWidget::draw_clip(QOpenGLFramebufferObject* fbo, GLuint texture, QOpenGLShaderProgram* program, bool mipmap) {
+	QMatrix4x4 projection;
+	projection.ortho(0, 1, 0, 1, -1, 1);
+
+	// fills the whole buffer
+	GLTextureCoords coords;
+	coords.vertexTopLeftX = coords.vertexBottomLeftX = coords.vertexTopLeftY = coords.vertexTopRightY = 0;
+	coords.vertexTopRightX = coords.vertexBottomRightX = coords.vertexBottomLeftY = coords.vertexBottomRightY = 1;
+	coords.textureTopLeftX = coords.textureBottomLeftX = coords.textureTopLeftY = coords.textureTopRightY = 0;
+	coords.textureTopRightX = coords.textureBottomRightX = coords.textureBottomLeftY = coords.textureBottomRightY = 1;
+
+	fbo->bind();
+	renderer.draw_quad(texture, projection, coords, program, mipmap);
+	fbo->release();
+	if (default_fbo != NULL) default_fbo->bind();
+
+	return fbo->texture();
+}
+
+GLuint ViewerWidget::compose_sequence(Clip* nest, long playhead, bool render_audio, QOpenGLFramebufferObject* nest_fbo, bool render_video) {
+	Sequence* s = (nest == NULL) ? sequence : static_cast<Sequence*>(nest->media);
+
+    QVector<Clip*> current_clips;
+	if (!get_active_clips(current_clips, s, nest, playhead, !rendering, render_video)) texture_failed = true;
+
+	int half_width = s->width/2;
+	int half_height = s->height/2;
+	if (rendering || nest != NULL) half_height = -half_height;
+	QMatrix4x4 projection;
+	projection.ortho(-half_width, half_width, half_height, -half_height, -1, 1);
+
+    for (int i=0;i<current_clips.size();i++) {
+		Clip* c = current_clips.at(i);
+
+        if (c->media_type == MEDIA_TYPE_FOOTAGE && !c->finished_opening) {
+            qDebug() << "[WARNING] Tried to display clip" << i << "but it's closed";
+            texture_failed = true;
+        } else {
+			if (c->track < 0) {
+				GLuint textureID = 0;
+				int video_width = c->getWidth();
+				int video_height = c->getHeight();
+
+				// size of the targets the clip's effects draw into, smaller than the clip at a reduced playback resolution
+				int render_width = get_render_size(video_width);
+				int render_height = get_render_size(video_height);
+
+				if (c->media_type == MEDIA_TYPE_FOOTAGE) {
+					// renders always use the full source, and keep retrying until the scaler has been reopened for it
+					if (rendering) c->target_decode_divisor = 1;
+					get_clip_frame(c, playhead);
+					if (rendering && c->decode_divisor != 1) texture_failed = true;
+					if (c->texture != NULL) textureID = c->texture->textureId();
+				} else if (c->media_type == MEDIA_TYPE_SEQUENCE) {
+					textureID = -1;
+				}
+
+				if (textureID == 0 && c->media_type != MEDIA_TYPE_SOLID) {
+					qDebug() << "[WARNING] Texture hasn't been created yet";
+					texture_failed = true;
+				} else if (playhead >= c->timeline_in) {
+					// for nested sequences, composed into a target of their own before this clip borrows its pair
+					QOpenGLFramebufferObject* sequence_fbo = NULL;
+					bool sequence_cached = false;
+					if (c->media_type == MEDIA_TYPE_SEQUENCE) {
+						sequence_fbo = compose_nest(c, nested_frame(c, playhead), render_audio, sequence_cached);
+						textureID = sequence_fbo->texture();
+					}
+
+					// effects that only move the clip are all folded into coords and applied in the final draw, so
+					// unless one draws into the clip it's composited straight from its source with no extra passes
+					bool draws_effects = (c->media_type == MEDIA_TYPE_SOLID);
+					for (int j=0;j<c->effects.size();j++) {
+						Effect* e = c->effects.at(j);
+						if (e->is_enabled() && (e->enable_shader || e->enable_superimpose)) draws_effects = true;
+					}
+
+					double timecode = ((double)(playhead-c->timeline_in+c->clip_in)/(double)s->frame_rate);
+
+					// if nothing the drawn effects depend on has changed since the last frame, reuse their output
+					QVector<QVariant> signature;
+					if (draws_effects) signature = layer_signature(c, timecode, render_width, render_height);
+					LayerKey layer_key(c, nest);
+					LayerCache* cached = NULL;
+					if (!signature.isEmpty() && layer_cache.contains(layer_key)) {
+						cached = &layer_cache[layer_key];
+						cached->used = true;
+						if (cached->signature != signature) cached = NULL;
+					}
+					bool cache_hit = (cached != NULL);
+
+					QOpenGLFramebufferObject* fbo[2] = {NULL, NULL};
+					QOpenGLFramebufferObject* result_fbo = NULL;
+					GLuint composite_texture = textureID;
+					if (cache_hit) {
+						composite_texture = cached->fbo->texture();
+					} else if (draws_effects) {
+						// borrow two targets to ping-pong effects between
+						for (int j=0;j<2;j++) {
+							fbo[j] = fbo_pool.acquire(render_width, render_height);
+							fbo[j]->bind();
+							glClear(GL_COLOR_BUFFER_BIT);
+							fbo[j]->release();
+						}
+
+						glViewport(0, 0, render_width, render_height);
+
+						if (c->media_type == MEDIA_TYPE_SOLID) {
+							composite_texture = fbo[0]->texture();
+						} else {
+							composite_texture = draw_clip(fbo[0], textureID);
+						}
+						result_fbo = fbo[0];
+					}
+
+					bool fbo_switcher = true;
+
+					GLTextureCoords coords;
+					coords.vertexTopLeftX = coords.vertexBottomLeftX = -video_width/2;
+					coords.vertexTopLeftY = coords.vertexTopRightY = -video_height/2;
+					coords.vertexTopRightX = coords.vertexBottomRightX = video_width/2;
+					coords.vertexBottomLeftY = coords.vertexBottomRightY = video_height/2;
+					coords.textureTopLeftY = coords.textureTopRightY = coords.textureTopLeftX = coords.textureBottomLeftX = 0;
+					coords.textureBottomLeftY = coords.textureBottomRightY = coords.textureTopRightX = coords.textureBottomRightX = 1.0;					
+
+					if (c->autoscale && (video_width != s->width || video_height != s->height)) {
+						double width_multiplier = (double) s->width / (double) video_width;
+						double height_multiplier = (double) s->height / (double) video_height;
+						double scale_multiplier = qMin(width_multiplier, height_multiplier);
+						coords.matrix.scale(scale_multiplier, scale_multiplier);
+					}
+
+					// EFFECT CODE START
+					for (int j=0;j<c->effects.size();j++) {
+						Effect* e = c->effects.at(j);
+						if (e->is_enabled()) {
+							if (e->enable_coords) {
+								e->process_coords(timecode, coords);
+							}
+							if (cache_hit) {
+								// drawn output comes from the cache, only the coordinates are needed
+							} else if (e->pointwise) {
+								// draw this and the per-pixel effects right after it in a single pass. coordinate-only
+								// effects don't draw anything, so they don't break the run
+								QVector<Effect*> chain;
+								chain.append(e);
+								while (j+1 < c->effects.size()) {
+									Effect* next = c->effects.at(j+1);
+									if (next->is_enabled()) {
+										if (next->pointwise) {
+											chain.append(next);
+										} else if (next->enable_shader || next->enable_superimpose) {
+											break;
+										} else if (next->enable_coords) {
+											next->process_coords(timecode, coords);
+										}
+									}
+									j++;
+								}
+
+								QOpenGLShaderProgram* program = Effect::bind_pointwise_chain(chain, timecode);
+								if (program != NULL) {
+									composite_texture = draw_clip(fbo[fbo_switcher], composite_texture, program);
+									program->release();
+									result_fbo = fbo[fbo_switcher];
+									fbo_switcher = !fbo_switcher;
+								}
+							} else if (e->enable_shader || e->enable_superimpose) {
+								e->startEffect();
+								for (int k=0;k<e->getIterations();k++) {
+									e->mipmap_input = false;
+									e->process_shader(timecode, k);
+									composite_texture = draw_clip(fbo[fbo_switcher], composite_texture, e->get_program(), e->mipmap_input);
+									if (e->enable_superimpose) {
+										GLuint superimpose_texture = e->process_superimpose(timecode, &renderer, &fbo_pool, default_fbo);
+										if (superimpose_texture != 0) draw_clip(fbo[fbo_switcher], superimpose_texture, e->get_program());
+									}
+									result_fbo = fbo[fbo_switcher];
+									fbo_switcher = !fbo_switcher;
+								}
+							}
+						}
+					}
+
+					if (c->opening_transition != NULL) {
+						int transition_progress = playhead - c->timeline_in;
+						if (transition_progress < c->opening_transition->length) {
+							c->opening_transition->process_transition((double)transition_progress/(double)c->opening_transition->length, coords);
+						}
+					}
+
+					if (c->closing_transition != NULL) {
+						int transition_progress = c->closing_transition->length - (playhead - c->timeline_in - c->getLength() + c->closing_transition->length);
+						if (transition_progress < c->closing_transition->length) {
+							c->closing_transition->process_transition((double)transition_progress/(double)c->closing_transition->length, coords);
+						}
+					}
+
+					for (int j=0;j<c->effects.size();j++) {
+						if ((c->effects.at(j)->enable_shader || c->effects.at(j)->enable_superimpose) && c->effects.at(j)->is_enabled()) {
+							c->effects.at(j)->endEffect();
+						}
+					}
+					// EFFECT CODE END
+
+					// pick the size the next frames of this clip get decoded at from how large it ended up on screen
+					if (c->media_type == MEDIA_TYPE_FOOTAGE && !rendering) {
+						double output_scale = (nest_fbo != NULL) ? render_scale : qMax((double) width() / s->width, (double) height() / s->height);
+						double display_scale = get_display_scale(coords, video_width, video_height) * output_scale;
+
+						// effects draw at the playback resolution, anything decoded beyond it is thrown away
+						if (draws_effects) display_scale = qMin(display_scale, render_scale);
+
+						// a zoom hovering around a boundary shouldn't keep reopening the scaler, so only drop to a smaller
+						// size once the clip is clearly below it
+						int divisor = get_decode_divisor(display_scale);
+						if (divisor > c->decode_divisor) divisor = qMax(c->decode_divisor, get_decode_divisor(display_scale*DECODE_SCALE_MARGIN));
+						c->target_decode_divisor = divisor;
+
+						// the frame just drawn is the wrong size until the scaler reopens on the next get_clip_frame(), which
+						// nothing else may ask for while paused. failing the texture gets it drawn again, and keeps a nest
+						// showing it out of the nest cache
+						if (c->target_decode_divisor != c->decode_divisor) texture_failed = true;
+					}
+
+					if (nest_fbo != NULL) {
+						nest_fbo->bind();
+						glViewport(0, 0, get_render_size(s->width), get_render_size(s->height));
+					} else if (rendering) {
+						glViewport(0, 0, s->width, s->height);
+					} else {
+						glViewport(0, 0, width(), height());
+					}
+
+					renderer.draw_quad(composite_texture, projection, coords);
+
+					if (nest_fbo != NULL) {
+						nest_fbo->release();
+						if (default_fbo != NULL) default_fbo->bind();
+					}
+
+					// keep the effects' output for the next frame, replacing whatever was cached for this clip before
+					if (!cache_hit && !signature.isEmpty() && result_fbo != NULL) {
+						if (layer_cache.contains(layer_key)) fbo_pool.give_back(layer_cache[layer_key].fbo);
+						fbo_pool.retain(result_fbo);
+						LayerCache& entry = layer_cache[layer_key];
+						entry.signature = signature;
+						entry.fbo = result_fbo;
+						entry.used = true;
+					}
+
+					// the draw above has been queued, so the targets can go to the next clip
+					for (int j=0;j<2;j++) {
+						if (fbo[j] != NULL && !(layer_cache.contains(layer_key) && layer_cache[layer_key].fbo == fbo[j])) fbo_pool.give_back(fbo[j]);
+					}
+					if (sequence_fbo != NULL && !sequence_cached) fbo_pool.give_back(sequence_fbo);
+				}
+			} else {
+				switch (c->media_type) {
+				case MEDIA_TYPE_FOOTAGE:
+				case MEDIA_TYPE_TONE:
+					if (render_audio
+							&& c->lock.tryLock()) {
+						// clip is not caching, start caching audio
+						cache_clip(c, playhead, false, false, c->audio_reset, nest);
+						c->lock.unlock();
+					}
+					break;
+				case MEDIA_TYPE_SEQUENCE:
+					compose_sequence(c, nested_frame(c, playhead), render_audio);
+					break;
+				}
+			}
+        }
+    }
+
+	return (nest_fbo != NULL) ? nest_fbo->texture() : 0;
+}
+
+void ViewerWidget::paintGL() {
+	// previews can composite clips below full size to keep up, anything rendered is always full size
+	render_scale = 1.0;
+	if (!rendering) {
+		switch (config.playback_resolution) {
+		case PLAYBACK_RESOLUTION_HALF:
+			render_scale = 0.5;
+			break;
+		case PLAYBACK_RESOLUTION_QUARTER:
+			render_scale = 0.25;
+			break;
+		case PLAYBACK_RESOLUTION_AUTO:
+			if (panel_timeline->playing) render_scale = 0.5;
+			break;
+		}
+	}
+
+	bool loop = false;
+	do {
+		loop = false;
+
+		glClearColor(0, 0, 0, 1);
+		glEnable(GL_BLEND);
+
+        texture_failed = false;
+
+		if (!rendering) retry_timer.stop();
+
+        glClear(GL_COLOR_BUFFER_BIT);
+
+		// compose video preview, unless the frame has already been rendered to the cache and only the audio is needed
+		glClearColor(0, 0, 0, 0);
+		bool render_audio = (panel_timeline->playing || rendering) && !skip_audio;
+		if (!rendering && ram_preview.is_playing()) {
+			// picture and sound both come from memory
+			QImage image = ram_preview.get_frame(sequence->playhead);
+			if (!image.isNull()) draw_frame_image(image);
+		} else if (!rendering && draw_cached_frame()) {
+			compose_sequence(NULL, sequence->playhead, render_audio, NULL, false);
+		} else {
+			compose_sequence(NULL, sequence->playhead, render_audio);
+		}
+		prune_layer_cache();
+		prune_nest_cache();
+		fbo_pool.end_frame();
+
+        if (texture_failed) {
+			if (rendering) {
+				qDebug() << "[INFO] Texture failed - looping";
+				loop = true;
+            } else {
+				retry_timer.start();
+            }
+        }
+
+        if (config.show_title_safe_area && !rendering) {
+            drawTitleSafeArea();
+        }
+
+		glDisable(GL_BLEND);
+	} while (loop);
+}
@@ -1,40 +1,87 @@
-#ifndef VIEWERWIDGET_H
-#define VIEWERWIDGET_H
-
-#include <QOpenGLWidget>
-#include <QMatrix4x4>
-#include <QOpenGLTexture>
-#include <QTimer>
-#include <QThread>
-#include <QMutex>
-#include <QWaitCondition>
-
-struct Clip;
-struct Sequence;
-class QOpenGLFramebufferObject;
-
-class ViewerWidget : public QOpenGLWidget
-{
-	Q_OBJECT
-public:
-	ViewerWidget(QWidget *parent = 0);
-
-	bool rendering;
-    void paintGL();
-    void initializeGL();
-
-	QOpenGLFramebufferObject* default_fbo;
-protected:
-    void paintEvent(QPaintEvent *e);
-//    void resizeGL(int w, int h);
-private:
-	QTimer retry_timer;
-    void drawTitleSafeArea();
-private slots:
-	void retry();
-    void deleteFunction();
-	GLuint compose_sequence(Clip *nest, bool render_audio);
-	GLuint draw_clip(QOpenGLFramebufferObject *clip, GLuint texture);
-};
-
-#endif // VIEWERWIDGET_H
+#ifndef VIEWERWIDGET_H
+#define VIEWERWIDGET_H
+
+#include <QOpenGLWidget>
+#include <QMatrix4x4>
+#include <QOpenGLTexture>
+#include <QTimer>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QHash>
+#include <QVector>
+#include <QVariant>
+#include <QPair>
+#include <QByteArray>
+
+#include "ui/renderer.h"
+#include "ui/framebufferpool.h"
+
+struct Clip;
+struct Sequence;
+class QOpenGLFramebufferObject;
+class QOpenGLShaderProgram;
+class QImage;
+
+// a clip's drawn effects output kept from an earlier frame, along with everything it was drawn from. kept per clip and
+// the nest clip it's drawn through, so instances of a nest at different frames each have their own. instances of an
+// outer nest sharing one inner nest clip still replace each other's entries, so those are redrawn every time
+typedef QPair<Clip*, Clip*> LayerKey;
+struct LayerCache {
+	QVector<QVariant> signature;
+	QOpenGLFramebufferObject* fbo;
+	bool used;
+};
+
+// a nested sequence's composited output at one of its frames, so every clip showing it there shares one draw
+struct NestCache {
+	QByteArray signature;
+	QOpenGLFramebufferObject* fbo;
+	bool exact; // drawn while rendering, so every texture was the exact frame
+	double scale; // render_scale it was drawn at
+	bool used;
+};
+
+class ViewerWidget : public QOpenGLWidget
+{
+	Q_OBJECT
+public:
+	ViewerWidget(QWidget *parent = 0);
+
+	bool rendering;
+	bool skip_audio; // set while rendering frames whose audio isn't needed
+    void paintGL();
+    void initializeGL();
+
+	QOpenGLFramebufferObject* default_fbo;
+	Renderer renderer;
+	FramebufferPool fbo_pool;
+
+	// draws frames of the current sequence offscreen at full size, the way an export does
+	void start_offscreen_render(bool audio);
+	void render_offscreen_frame(QImage& image);
+	void end_offscreen_render();
+protected:
+    void paintEvent(QPaintEvent *e);
+//    void resizeGL(int w, int h);
+private:
+	QTimer retry_timer;
+    void drawTitleSafeArea();
+	QVector<QVariant> layer_signature(Clip* c, double timecode, int width, int height);
+	void prune_layer_cache();
+	QHash<LayerKey, LayerCache> layer_cache;
+	QOpenGLFramebufferObject* compose_nest(Clip* c, long frame, bool render_audio, bool& cached);
+	void prune_nest_cache();
+	QHash<QPair<Sequence*, long>, NestCache> nest_cache;
+	bool draw_cached_frame();
+	void draw_frame_image(const QImage& image);
+	QOpenGLTexture* cached_frame_texture;
+	QOpenGLFramebufferObject* offscreen_fbo;
+private slots:
+	void retry();
+    void deleteFunction();
+	GLuint compose_sequence(Clip *nest, long playhead, bool render_audio, QOpenGLFramebufferObject* nest_fbo = NULL, bool render_video = true);
+	GLuint draw_clip(QOpenGLFramebufferObject *clip, GLuint texture, QOpenGLShaderProgram* program = NULL, bool mipmap = false);
+};
+
+#endif // VIEWERWIDGET_H